@@ -1496,6 +1496,7 @@ static void _add_main_groups_buttons (void)
 	_add_sub_group_to_group_button (pGroupDescription, "System", "icon-system.svg", _("System"));
 	pGroupDescription->pManagers = g_list_prepend (pGroupDescription->pManagers, (gchar*)"Docks");
 	pGroupDescription->pManagers = g_list_prepend (pGroupDescription->pManagers, (gchar*)"Connection");
+	pGroupDescription->pManagers = g_list_prepend (pGroupDescription->pManagers, (gchar*)"Tasks");
 	pGroupDescription->pManagers = g_list_prepend (pGroupDescription->pManagers, (gchar*)"Containers");
 	pGroupDescription->pManagers = g_list_prepend (pGroupDescription->pManagers, (gchar*)"Backends");
 	pGroupDescription->build_widget = _build_config_group_widget;
@@ -54,6 +54,9 @@
 
 #include <glib/gstdio.h>
 #include <dbus/dbus-glib.h>  // dbus_g_thread_init
+#if GLIB_CHECK_VERSION (2, 30, 0)
+#include <glib-unix.h>  // g_unix_signal_add
+#endif
 
 #include "config.h"
 #include "cairo-dock-icon-facility.h"  // cairo_dock_get_first_icon
@@ -72,6 +75,7 @@
 #include "cairo-dock-packages.h"
 #include "cairo-dock-utils.h"  // cairo_dock_launch_command
 #include "cairo-dock-core.h"
+#include "cairo-dock-profiler.h"
 
 #include "cairo-dock-gui-manager.h"
 #include "cairo-dock-gui-backend.h"
@@ -169,6 +173,16 @@ static void _cairo_dock_quit (G_GNUC_UNUSED int signal)
 {
 	gtk_main_quit ();
 }
+#if GLIB_CHECK_VERSION (2, 30, 0)
+static gboolean _cairo_dock_dump_profile (G_GNUC_UNUSED gpointer data)
+{
+	gchar *cFilePath = g_strdup_printf ("%s/cairo-dock-profile-%d.txt", g_get_tmp_dir (), getpid ());
+	if (gldi_profiler_dump_to_file (cFilePath))
+		cd_warning ("profiling data written in %s", cFilePath);
+	g_free (cFilePath);
+	return TRUE;
+}
+#endif
 /* Crash at startup:
  *  - First 2 crashes: retry with a delay of 2 sec (maybe due to a problem at startup)
  *  - 3th crash: remove the applet and restart the dock
@@ -340,7 +354,7 @@ int main (int argc, char** argv)
 	textdomain (CAIRO_DOCK_GETTEXT_PACKAGE);
 	
 	//\___________________ get app's options.
-	gboolean bSafeMode = FALSE, bMaintenance = FALSE, bNoSticky = FALSE, bCappuccino = FALSE, bPrintVersion = FALSE, bTesting = FALSE, bForceOpenGL = FALSE, bToggleIndirectRendering = FALSE, bKeepAbove = FALSE, bForceColors = FALSE, bAskBackend = FALSE, bMetacityWorkaround = FALSE;
+	gboolean bSafeMode = FALSE, bMaintenance = FALSE, bNoSticky = FALSE, bCappuccino = FALSE, bPrintVersion = FALSE, bTesting = FALSE, bForceOpenGL = FALSE, bToggleIndirectRendering = FALSE, bUseShaders = FALSE, bKeepAbove = FALSE, bForceColors = FALSE, bAskBackend = FALSE, bMetacityWorkaround = FALSE, bProfile = FALSE;
 	gchar *cEnvironment = NULL, *cUserDefinedDataDir = NULL, *cVerbosity = 0, *cUserDefinedModuleDir = NULL, *cExcludeModule = NULL, *cThemeServerAdress = NULL;
 	int iDelay = 0;
 	GOptionEntry pOptionsTable[] =
@@ -355,6 +369,9 @@ int main (int argc, char** argv)
 		{"indirect-opengl", 'O', G_OPTION_FLAG_IN_MAIN, G_OPTION_ARG_NONE,
 			&bToggleIndirectRendering,
 			_("Use OpenGL backend with indirect rendering. There are very few case where this option should be used."), NULL},
+		{"opengl-shaders", 'G', G_OPTION_FLAG_IN_MAIN, G_OPTION_ARG_NONE,
+			&bUseShaders,
+			_("Draw the icons with GLSL shaders in the OpenGL backend (experimental)."), NULL},
 		{"ask-backend", 'A', G_OPTION_FLAG_IN_MAIN, G_OPTION_ARG_NONE,
 			&bAskBackend,
 			_("Ask again on startup which backend to use."), NULL},
@@ -413,6 +430,9 @@ int main (int argc, char** argv)
 		{"easter-eggs", 'E', G_OPTION_FLAG_IN_MAIN, G_OPTION_ARG_NONE,
 			&g_bEasterEggs,
 			_("For debugging purpose only. Some hidden and still unstable options will be activated."), NULL},
+		{"profile", 'P', G_OPTION_FLAG_IN_MAIN, G_OPTION_ARG_NONE,
+			&bProfile,
+			_("For debugging purpose only. Measure the time spent in the notifications and in the drawing; send the SIGUSR1 signal to write the results in a file."), NULL},
 		{NULL, 0, 0, 0,
 			NULL,
 			NULL, NULL}
@@ -521,6 +541,9 @@ int main (int argc, char** argv)
 	if (bToggleIndirectRendering)
 		gldi_gl_backend_force_indirect_rendering ();
 	
+	if (bUseShaders)
+		gldi_gl_backend_use_shaders ();
+	
 	gchar *cExtraDirPath = g_strconcat (cRootDataDirPath, "/"CAIRO_DOCK_EXTRAS_DIR, NULL);
 	gchar *cThemesDirPath = g_strconcat (cRootDataDirPath, "/"CAIRO_DOCK_THEMES_DIR, NULL);
 	gchar *cCurrentThemeDirPath = g_strconcat (cRootDataDirPath, "/"CAIRO_DOCK_CURRENT_THEME_NAME, NULL);
@@ -703,6 +726,15 @@ int main (int argc, char** argv)
 	//\___________________ handle terminate signals to quit properly (especially when the system shuts down).
 	signal (SIGTERM, _cairo_dock_quit);  // Term // kill -15 (system)
 	signal (SIGHUP,  _cairo_dock_quit);  // sent to a process when its controlling terminal is closed
+	
+	//\___________________ profiling.
+	if (bProfile)
+	{
+		gldi_profiler_enable (TRUE);
+		#if GLIB_CHECK_VERSION (2, 30, 0)
+		g_unix_signal_add (SIGUSR1, _cairo_dock_dump_profile, NULL);  // kill -USR1
+		#endif
+	}
 
 	//\___________________ Disable modules that have crashed
 	if (cExcludeModule != NULL && (s_iNbCrashes > 2 || bMaintenance)) // 3th crash or 4th (with -m)
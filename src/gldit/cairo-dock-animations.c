@@ -135,6 +135,60 @@ gfloat cairo_dock_calculate_magnitude (gint iMagnitudeIndex)  // merci a Robrob
 }
 
 
+#if GTK_CHECK_VERSION (3, 8, 0)
+static gboolean _animation_tick (G_GNUC_UNUSED GtkWidget *pWidget, GdkFrameClock *pFrameClock, GldiContainer *pContainer)
+{
+	GldiContainerPrivate *priv = pContainer->priv;  // it outlives the container if it's destroyed by the loop.
+	
+	// wait for the frame that is the closest to the next step.
+	gint64 iFrameTime = gdk_frame_clock_get_frame_time (pFrameClock);  // in us
+	gint64 iRefreshInterval = 0;
+	gdk_frame_clock_get_refresh_info (pFrameClock, iFrameTime, &iRefreshInterval, NULL);
+	gint64 iDeltaT = (gint64)pContainer->iAnimationDeltaT * 1000;
+	gint64 iElapsed = iFrameTime - priv->iLastAnimationTime;
+	if (priv->iLastAnimationTime != 0 && iElapsed < priv->iAnimationSlowdown * iDeltaT - iRefreshInterval / 2)
+		return TRUE;
+	
+	// count the steps that fit in the elapsed time, so that the slow animations keep their pace, and the ones we missed.
+	int iNbSteps = 1;
+	if (priv->iLastAnimationTime != 0)
+	{
+		iNbSteps = MAX (1, (iElapsed + iRefreshInterval / 2) / iDeltaT);
+		if (iNbSteps > priv->iAnimationSlowdown)  // the main loop or the compositor made us late
+		{
+			priv->iNbDroppedFrames += iNbSteps - priv->iAnimationSlowdown;
+			cd_debug ("%d animation step(s) dropped (%d in total)", iNbSteps - priv->iAnimationSlowdown, priv->iNbDroppedFrames);
+		}
+	}
+	priv->iLastAnimationTime = iFrameTime;
+	pContainer->iAnimationStep += iNbSteps - 1;
+	
+	// if nothing was drawn since the previous step, only slow animations are running (or nothing visible) -> go slower, but not slower than the slow animations.
+	if (priv->bAnimationFrameDrawn)
+		priv->iAnimationSlowdown = 1;
+	else if (2 * priv->iAnimationSlowdown * pContainer->iAnimationDeltaT <= CAIRO_DOCK_MIN_SLOW_DELTA_T)
+		priv->iAnimationSlowdown *= 2;
+	priv->bAnimationFrameDrawn = FALSE;
+	
+	priv->bInAnimationTick = TRUE;
+	gboolean bContinue = pContainer->iface.animation_loop (pContainer);
+	priv->bInAnimationTick = FALSE;
+	if (priv->bDestroyed)  // the tick callback has been removed along with the container.
+	{
+		g_free (priv);
+		return FALSE;
+	}
+	if (priv->bRelaunchAnimation)  // the window has been unmapped, the tick callback has been removed and the frame clock won't tick any more -> continue on a timer.
+	{
+		priv->bRelaunchAnimation = FALSE;
+		if (bContinue && pContainer->iSidGLAnimation == 0)
+			cairo_dock_launch_animation (pContainer);
+		return FALSE;
+	}
+	return bContinue;
+}
+#endif
+
 void cairo_dock_launch_animation (GldiContainer *pContainer)
 {
 	if (pContainer->iSidGLAnimation == 0 && pContainer->iface.animation_loop != NULL)
@@ -142,8 +196,37 @@ void cairo_dock_launch_animation (GldiContainer *pContainer)
 		int iAnimationDeltaT = cairo_dock_get_animation_delta_t (pContainer);
 		pContainer->bKeepSlowAnimation = TRUE;
 		
+		#if GTK_CHECK_VERSION (3, 8, 0)
+		if (gtk_widget_get_mapped (pContainer->pWidget))  // follow the frame clock of the window, so that each step is drawn on the next frame.
+		{
+			pContainer->priv->bAnimationOnFrameClock = TRUE;
+			pContainer->priv->iLastAnimationTime = 0;
+			pContainer->priv->iAnimationSlowdown = 1;
+			pContainer->priv->bAnimationFrameDrawn = TRUE;
+			pContainer->iSidGLAnimation = gtk_widget_add_tick_callback (pContainer->pWidget, (GtkTickCallback)_animation_tick, pContainer, NULL);
+			return;
+		}
+		#endif
+		pContainer->priv->bAnimationOnFrameClock = FALSE;  // no frame clock running on an unmapped window.
 		pContainer->iSidGLAnimation = g_timeout_add (iAnimationDeltaT, (GSourceFunc)pContainer->iface.animation_loop, pContainer);
 	}
+	else
+	{
+		pContainer->priv->iAnimationSlowdown = 1;  // something new to animate -> back to the normal rate.
+	}
+}
+
+void cairo_dock_stop_animation (GldiContainer *pContainer)
+{
+	if (pContainer->iSidGLAnimation == 0)
+		return;
+	#if GTK_CHECK_VERSION (3, 8, 0)
+	if (pContainer->priv->bAnimationOnFrameClock)
+		gtk_widget_remove_tick_callback (pContainer->pWidget, pContainer->iSidGLAnimation);
+	else
+	#endif
+	g_source_remove (pContainer->iSidGLAnimation);
+	pContainer->iSidGLAnimation = 0;
 }
 
 void cairo_dock_start_shrinking (CairoDock *pDock)
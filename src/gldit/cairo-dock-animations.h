@@ -115,6 +115,11 @@ gfloat cairo_dock_calculate_magnitude (gint iMagnitudeIndex);
 */
 void cairo_dock_launch_animation (GldiContainer *pContainer);
 
+/** Stop the animation of a Container, whether it is driven by the frame clock of its window or by a timer.
+*@param pContainer the container.
+*/
+void cairo_dock_stop_animation (GldiContainer *pContainer);
+
 void cairo_dock_start_shrinking (CairoDock *pDock);
 
 void cairo_dock_start_growing (CairoDock *pDock);
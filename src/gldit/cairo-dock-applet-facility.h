@@ -652,6 +652,12 @@ gldi_shortkey_new (cShortKey, myApplet->pModule->pVisitCard->cTitle, cDescriptio
 */
 #define CD_APPLET_RENDER_NEW_DATA_ON_MY_ICON(pValues) cairo_dock_render_new_data_on_icon (myIcon, myContainer, myDrawContext, pValues)
 
+/** Add several sets of values at once to the Data Renderer of the applet's icon, the oldest first, and redraw it only once.
+*@param pValues the values, a table of iNbSamples x (number of values) double.
+*@param iNbSamples the number of sets of values.
+*/
+#define CD_APPLET_RENDER_NEW_DATA_BATCH_ON_MY_ICON(pValues, iNbSamples) cairo_dock_render_new_data_batch_on_icon (myIcon, myContainer, myDrawContext, pValues, iNbSamples)
+
 /** Completely remove the Data Renderer of the applet's icon, including the values associated with.
 */
 #define CD_APPLET_REMOVE_MY_DATA_RENDERER cairo_dock_remove_data_renderer_on_icon (myIcon)
@@ -45,10 +45,12 @@
 #include "cairo-dock-application-facility.h"
 #include "cairo-dock-windows-manager.h"
 #include "cairo-dock-overlay.h"  // cairo_dock_print_overlay_on_icon
+#include "cairo-dock-task.h"
 #define _MANAGER_DEF_
 #include "cairo-dock-applications-manager.h"
 
 #define CAIRO_DOCK_DEFAULT_APPLI_ICON_NAME "default-icon-appli.svg"
+#define CD_APPLI_ICON_RELOAD_DELAY 100  // ms; changes of the X icon during this time are merged into a single reload.
 
 // public (manager, config, data)
 CairoTaskbarParam myTaskbarParam;
@@ -64,6 +66,15 @@ extern gboolean g_bUseOpenGL;
 static GHashTable *s_hAppliIconsTable = NULL;  // table des fenetres affichees dans le dock.
 static int s_bAppliManagerIsRunning = FALSE;
 static GldiWindowActor *s_pCurrentActiveWindow = NULL;
+static GHashTable *s_hIconReloadTasks = NULL;  // appli-icon -> task reloading its X icon
+
+typedef struct {
+	Icon *pIcon;
+	GldiWindowActor *pAppli;  // we hold a reference on it, since the worker uses it
+	gint iWidth, iHeight;  // size at which the icon is fetched; only modified while the task is not running
+	cairo_surface_t *pSurface;  // result of the fetch
+	gboolean bChangedAgain;  // the icon changed while it was being fetched
+	} CDAppliIconReload;
 
 static void cairo_dock_unregister_appli (Icon *icon);
 
@@ -151,6 +162,78 @@ static gboolean _on_window_name_changed (G_GNUC_UNUSED gpointer data, GldiWindow
 	return GLDI_NOTIFICATION_LET_PASS;
 }
 
+static inline gboolean _appli_icon_shows_xicon (Icon *icon)
+{
+	// a minimized window may be drawn with its thumbnail or bent, in which case the icon is more than the X icon.
+	return ((cairo_dock_class_is_using_xicon (icon->cClass) || ! myTaskbarParam.bOverWriteXIcons)
+		&& ! (icon->pAppli->bIsHidden && myTaskbarParam.iMinimizedWindowRenderType != 0));
+}
+static void _reload_appli_icon_image (Icon *icon, GldiContainer *pContainer)
+{
+	cairo_dock_load_icon_image (icon, pContainer);
+	if (CAIRO_DOCK_IS_DOCK (pContainer))
+	{
+		CairoDock *pDock = CAIRO_DOCK (pContainer);
+		if (pDock->iRefCount != 0)
+			cairo_dock_trigger_redraw_subdock_content (pDock);
+	}
+	cairo_dock_redraw_icon (icon);
+}
+static void _get_xicon_threaded (CDAppliIconReload *pReload)
+{
+	pReload->pSurface = gldi_window_get_icon_surface_threaded (pReload->pAppli, pReload->iWidth, pReload->iHeight);
+}
+static gboolean _update_xicon (CDAppliIconReload *pReload)
+{
+	Icon *icon = pReload->pIcon;
+	cairo_surface_t *pSurface = pReload->pSurface;
+	pReload->pSurface = NULL;
+	
+	GldiContainer *pContainer = cairo_dock_get_icon_container (icon);
+	if (pContainer != NULL && icon->pAppli == pReload->pAppli && _appli_icon_shows_xicon (icon))  // the icon may have been detached or minimized in the meantime.
+	{
+		if (pSurface != NULL
+		&& pReload->iWidth == cairo_dock_icon_get_allocated_width (icon)
+		&& pReload->iHeight == cairo_dock_icon_get_allocated_height (icon))  // just swap the image.
+		{
+			cairo_dock_unload_image_buffer (&icon->image);
+			cairo_dock_load_image_buffer_from_surface (&icon->image, pSurface, pReload->iWidth, pReload->iHeight);
+			pSurface = NULL;  // the image buffer has taken it.
+			cairo_dock_apply_icon_background (icon);  // like cairo_dock_load_icon_image() does.
+			if (CAIRO_DOCK_IS_DOCK (pContainer))
+			{
+				CairoDock *pDock = CAIRO_DOCK (pContainer);
+				if (pDock->iRefCount != 0)
+					cairo_dock_trigger_redraw_subdock_content (pDock);
+			}
+			cairo_dock_redraw_icon (icon);
+		}
+		else  // no _NET_WM_ICON or the icon has been resized -> do it the usual way.
+		{
+			_reload_appli_icon_image (icon, pContainer);
+		}
+	}
+	if (pSurface != NULL)
+		cairo_surface_destroy (pSurface);
+	
+	// if the icon changed again during the fetch, fetch it again.
+	if (pReload->bChangedAgain)
+	{
+		pReload->bChangedAgain = FALSE;
+		pReload->iWidth = cairo_dock_icon_get_allocated_width (icon);
+		pReload->iHeight = cairo_dock_icon_get_allocated_height (icon);
+		GldiTask *pTask = g_hash_table_lookup (s_hIconReloadTasks, icon);
+		gldi_task_launch_delayed (pTask, CD_APPLI_ICON_RELOAD_DELAY);
+	}
+	return TRUE;  // the task has no period, so it won't be re-launched by itself; this just keeps the delayed launch above.
+}
+static void _free_xicon_reload (CDAppliIconReload *pReload)
+{
+	if (pReload->pSurface != NULL)
+		cairo_surface_destroy (pReload->pSurface);
+	gldi_object_unref (GLDI_OBJECT (pReload->pAppli));
+	g_free (pReload);
+}
 static gboolean _on_window_icon_changed (G_GNUC_UNUSED gpointer data, GldiWindowActor *actor)
 {
 	Icon *icon = _get_appli_icon (actor);
@@ -162,14 +245,38 @@ static gboolean _on_window_icon_changed (G_GNUC_UNUSED gpointer data, GldiWindow
 		GldiContainer *pContainer = cairo_dock_get_icon_container (icon);
 		if (pContainer != NULL)  // if the icon is not in a container (for instance inhibited), it's no use trying to load its image. It's not even useful to mark it as 'damaged', since anyway it will be loaded when inserted inside a container.
 		{
-			cairo_dock_load_icon_image (icon, pContainer);
-			if (CAIRO_DOCK_IS_DOCK (pContainer))
+			if (! gldi_window_can_get_icon_surface_threaded () || ! _appli_icon_shows_xicon (icon))
 			{
-				CairoDock *pDock = CAIRO_DOCK (pContainer);
-				if (pDock->iRefCount != 0)
-					cairo_dock_trigger_redraw_subdock_content (pDock);
+				_reload_appli_icon_image (icon, pContainer);
+				return GLDI_NOTIFICATION_LET_PASS;
 			}
-			cairo_dock_redraw_icon (icon);
+			
+			// some applis change their icon very often (badges, progress), so fetch it a bit later, and in a thread (the icon can be big, and has to be scaled).
+			GldiTask *pTask = g_hash_table_lookup (s_hIconReloadTasks, icon);
+			if (pTask == NULL)
+			{
+				CDAppliIconReload *pReload = g_new0 (CDAppliIconReload, 1);
+				pReload->pIcon = icon;
+				pReload->pAppli = actor;
+				gldi_object_ref (GLDI_OBJECT (actor));
+				pTask = gldi_task_new_full (0,
+					(GldiGetDataAsyncFunc) _get_xicon_threaded,
+					(GldiUpdateSyncFunc) _update_xicon,
+					(GFreeFunc) _free_xicon_reload,
+					pReload);
+				g_hash_table_insert (s_hIconReloadTasks, icon, pTask);
+			}
+			CDAppliIconReload *pReload = pTask->pSharedMemory;
+			if (gldi_task_is_running (pTask))  // being fetched -> the result will be outdated, fetch it again once it's done.
+			{
+				pReload->bChangedAgain = TRUE;
+			}
+			else if (! gldi_task_is_active (pTask))  // not yet planned
+			{
+				pReload->iWidth = cairo_dock_icon_get_allocated_width (icon);
+				pReload->iHeight = cairo_dock_icon_get_allocated_height (icon);
+				gldi_task_launch_delayed (pTask, CD_APPLI_ICON_RELOAD_DELAY);
+			}  // else already planned, it will get the current icon.
 		}
 	}
 	
@@ -830,12 +937,11 @@ static void reset_config (CairoTaskbarParam *pTaskBar)
  /// LOAD ///
 ////////////
 
-/*
 static void load (void)
 {
-	
+	// index the .desktop files in the background, so that it's ready when the launchers and the applications are created; it's not done in the 'init', since the tasks config is not read yet.
+	cairo_dock_start_desktop_files_index ();
 }
-*/
 
   //////////////
  /// RELOAD ///
@@ -925,6 +1031,8 @@ static void init (void)
 		NULL,  // window actor
 		NULL);  // appli-icon
 	
+	s_hIconReloadTasks = g_hash_table_new (g_direct_hash, g_direct_equal);
+	
 	cairo_dock_initialize_class_manager ();
 	
 	gldi_object_register_notification (&myWindowObjectMgr,
@@ -1006,6 +1114,12 @@ static void init_object (GldiObject *obj, gpointer attr)
 static void reset_object (GldiObject *obj)
 {
 	Icon *pIcon = (Icon*)obj;
+	GldiTask *pTask = g_hash_table_lookup (s_hIconReloadTasks, pIcon);
+	if (pTask != NULL)
+	{
+		g_hash_table_remove (s_hIconReloadTasks, pIcon);
+		gldi_task_discard (pTask);  // if it's running, it will be freed once the worker is done.
+	}
 	cairo_dock_unregister_appli (pIcon);
 }
 
@@ -1017,7 +1131,7 @@ void gldi_register_applications_manager (void)
 	myTaskbarMgr.cModuleName    = "Taskbar";
 	// interface
 	myTaskbarMgr.init           = init;
-	myTaskbarMgr.load           = NULL;  // the manager is started after the launchers&applets have been created, to avoid unecessary computations.
+	myTaskbarMgr.load           = load;  // the applications are only registered after the launchers&applets have been created, to avoid unecessary computations (see cairo_dock_start_applications_manager).
 	myTaskbarMgr.unload         = unload;
 	myTaskbarMgr.reload         = (GldiManagerReloadFunc)reload;
 	myTaskbarMgr.get_config     = (GldiManagerGetConfigFunc)get_config;
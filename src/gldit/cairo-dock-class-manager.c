@@ -51,12 +51,45 @@
 #include "cairo-dock-keyfile-utilities.h"
 #include "cairo-dock-file-manager.h"
 #include "cairo-dock-windows-manager.h"
+#include "cairo-dock-task.h"
 #include "cairo-dock-class-manager.h"
 
 extern CairoDock *g_pMainDock;
 extern CairoDockDesktopEnv g_iDesktopEnv;
 
 static GHashTable *s_hClassTable = NULL;
+// index of the .desktop files of the applications, built in a thread at startup and updated file by file when the folders change.
+typedef struct {
+	gint iPriority;  // rank of its folder, the lower the more important
+	gchar *cFileName;
+	gchar *cLowerName;
+	gchar *cWmClass;  // class from StartupWMClass, or NULL
+	gchar *cCommandClass;  // class guessed from Exec, or NULL
+	} CDDesktopFileInfo;
+typedef struct {
+	gchar *cDirPath;
+	gint iPriority;
+	GFileMonitor *pMonitor;  // on the folder, or on its nearest parent as long as it doesn't exist
+	gboolean bWatchingParent;
+	} CDDesktopFilesDir;
+typedef struct {
+	gchar **cDirPaths;  // by order of priority
+	GHashTable *pFiles, *pByName, *pByWmClass, *pByCommand;
+	} CDDesktopFilesIndex;
+typedef enum {
+	CD_DESKTOP_FILES_BY_NAME,
+	CD_DESKTOP_FILES_BY_WMCLASS,
+	CD_DESKTOP_FILES_BY_COMMAND
+	} CDDesktopFilesIndexType;
+static GHashTable *s_hDesktopFiles = NULL;  // path -> CDDesktopFileInfo
+static GHashTable *s_hDesktopFilesByName = NULL;  // file name -> path
+static GHashTable *s_hDesktopFilesByWmClass = NULL;  // class from StartupWMClass -> path
+static GHashTable *s_hDesktopFilesByCommand = NULL;  // class guessed from Exec -> path, or "" if several applications share it
+static gboolean s_bDesktopFilesIndexIsValid = FALSE;
+static GHashTable *s_hPendingDesktopFiles = NULL;  // path -> priority, files that changed while the index was built
+static GList *s_pDesktopFilesDirs = NULL;  // list of CDDesktopFilesDir
+static GldiTask *s_pDesktopFilesIndexTask = NULL;
+
 
 
 static void cairo_dock_free_class_appli (CairoDockClassAppli *pClassAppli)
@@ -1579,6 +1612,398 @@ const CairoDockImageBuffer *cairo_dock_get_class_image_buffer (const gchar *cCla
 }
 
 
+static void _free_desktop_file_info (CDDesktopFileInfo *pInfo)
+{
+	if (pInfo == NULL)
+		return;
+	g_free (pInfo->cFileName);
+	g_free (pInfo->cLowerName);
+	g_free (pInfo->cWmClass);
+	g_free (pInfo->cCommandClass);
+	g_free (pInfo);
+}
+static CDDesktopFileInfo *_read_desktop_file_info (const gchar *cPath, gint iPriority)  // thread-safe
+{
+	if (! g_file_test (cPath, G_FILE_TEST_EXISTS))
+		return NULL;
+	CDDesktopFileInfo *pInfo = g_new0 (CDDesktopFileInfo, 1);
+	pInfo->iPriority = iPriority;
+	
+	// by file name (we also index it in lower case, to handle stupid cases like Thunar.desktop).
+	pInfo->cFileName = g_path_get_basename (cPath);
+	pInfo->cLowerName = g_ascii_strdown (pInfo->cFileName, -1);
+	
+	// by class, for the applications whose .desktop file is not named after their class.
+	GKeyFile *pKeyFile = g_key_file_new ();
+	if (g_key_file_load_from_file (pKeyFile, cPath, G_KEY_FILE_NONE, NULL))
+	{
+		gchar *cStartupWMClass = g_key_file_get_string (pKeyFile, "Desktop Entry", "StartupWMClass", NULL);
+		if (cStartupWMClass != NULL && *cStartupWMClass != '\0')
+			pInfo->cWmClass = cairo_dock_guess_class (NULL, cStartupWMClass);
+		g_free (cStartupWMClass);
+		
+		gchar *cCommand = g_key_file_get_string (pKeyFile, "Desktop Entry", "Exec", NULL);
+		if (cCommand != NULL)
+			pInfo->cCommandClass = cairo_dock_guess_class (cCommand, NULL);
+		g_free (cCommand);
+	}
+	g_key_file_free (pKeyFile);
+	return pInfo;
+}
+
+  ///////////////////////////
+ /// INITIAL INDEX TASK ///
+///////////////////////////
+
+static void _index_desktop_file (GHashTable *pIndex, const gchar *cKey, const gchar *cPath, gboolean bUnique)
+{
+	if (cKey == NULL || *cKey == '\0')
+		return;
+	const gchar *cKnownPath = g_hash_table_lookup (pIndex, cKey);
+	if (cKnownPath == NULL)  // the folders are read by order of priority, so keep the first file found.
+		g_hash_table_insert (pIndex, g_strdup (cKey), g_strdup (cPath));
+	else if (bUnique && *cKnownPath != '\0')  // ambiguous key, don't use it.
+		g_hash_table_insert (pIndex, g_strdup (cKey), g_strdup (""));
+}
+static void _build_desktop_files_index (CDDesktopFilesIndex *pIndex)  // thread-safe: it only reads the folders and fills the tables of the index.
+{
+	const gchar *cFileName;
+	gchar *cPath;
+	CDDesktopFileInfo *pInfo;
+	int i;
+	for (i = 0; pIndex->cDirPaths[i] != NULL; i ++)
+	{
+		GDir *dir = g_dir_open (pIndex->cDirPaths[i], 0, NULL);
+		if (dir == NULL)
+			continue;
+		while ((cFileName = g_dir_read_name (dir)) != NULL)
+		{
+			if (! g_str_has_suffix (cFileName, ".desktop"))
+				continue;
+			cPath = g_strdup_printf ("%s/%s", pIndex->cDirPaths[i], cFileName);
+			pInfo = _read_desktop_file_info (cPath, i);
+			if (pInfo != NULL)
+			{
+				_index_desktop_file (pIndex->pByName, pInfo->cFileName, cPath, FALSE);
+				_index_desktop_file (pIndex->pByName, pInfo->cLowerName, cPath, FALSE);
+				_index_desktop_file (pIndex->pByWmClass, pInfo->cWmClass, cPath, FALSE);
+				_index_desktop_file (pIndex->pByCommand, pInfo->cCommandClass, cPath, TRUE);  // several .desktop files can launch the same program (with different options), in which case we can't tell which one a window belongs to.
+				g_hash_table_insert (pIndex->pFiles, cPath, pInfo);  // takes the path
+			}
+			else
+				g_free (cPath);
+		}
+		g_dir_close (dir);
+	}
+}
+static void _update_desktop_file (const gchar *cPath, gint iPriority);
+static gboolean _on_desktop_files_index_built (CDDesktopFilesIndex *pIndex)
+{
+	// take the tables of the index.
+	s_hDesktopFiles = pIndex->pFiles;
+	s_hDesktopFilesByName = pIndex->pByName;
+	s_hDesktopFilesByWmClass = pIndex->pByWmClass;
+	s_hDesktopFilesByCommand = pIndex->pByCommand;
+	pIndex->pFiles = pIndex->pByName = pIndex->pByWmClass = pIndex->pByCommand = NULL;
+	s_bDesktopFilesIndexIsValid = TRUE;
+	cd_debug ("%d desktop files indexed", g_hash_table_size (s_hDesktopFiles));
+	
+	// apply the changes that happened in the meantime.
+	GHashTableIter iter;
+	gpointer key, value;
+	g_hash_table_iter_init (&iter, s_hPendingDesktopFiles);
+	while (g_hash_table_iter_next (&iter, &key, &value))
+	{
+		_update_desktop_file (key, GPOINTER_TO_INT (value));
+	}
+	g_hash_table_remove_all (s_hPendingDesktopFiles);
+	return FALSE;  // the task is not periodic, nothing more to do.
+}
+static void _free_desktop_files_index (CDDesktopFilesIndex *pIndex)
+{
+	if (pIndex->pFiles != NULL)  // the task was discarded before it finished.
+	{
+		g_hash_table_destroy (pIndex->pFiles);
+		g_hash_table_destroy (pIndex->pByName);
+		g_hash_table_destroy (pIndex->pByWmClass);
+		g_hash_table_destroy (pIndex->pByCommand);
+	}
+	g_strfreev (pIndex->cDirPaths);
+	g_free (pIndex);
+}
+
+  /////////////////////////
+ /// INCREMENTAL UPDATE ///
+/////////////////////////
+
+static gboolean _desktop_file_matches_key (CDDesktopFileInfo *pInfo, const gchar *cKey, CDDesktopFilesIndexType iType)
+{
+	switch (iType)
+	{
+		case CD_DESKTOP_FILES_BY_NAME:
+			return (strcmp (pInfo->cFileName, cKey) == 0 || strcmp (pInfo->cLowerName, cKey) == 0);
+		case CD_DESKTOP_FILES_BY_WMCLASS:
+			return (pInfo->cWmClass != NULL && strcmp (pInfo->cWmClass, cKey) == 0);
+		case CD_DESKTOP_FILES_BY_COMMAND:
+		default:
+			return (pInfo->cCommandClass != NULL && strcmp (pInfo->cCommandClass, cKey) == 0);
+	}
+}
+static void _update_index_key (const gchar *cKey, CDDesktopFilesIndexType iType)
+{
+	if (cKey == NULL || *cKey == '\0')
+		return;
+	// look for the files that have this key, and keep the one in the folder of highest priority, as the initial index does.
+	const gchar *cBestPath = NULL;
+	gint iBestPriority = G_MAXINT;
+	int iNbFiles = 0;
+	GHashTableIter iter;
+	gpointer key, value;
+	CDDesktopFileInfo *pInfo;
+	g_hash_table_iter_init (&iter, s_hDesktopFiles);
+	while (g_hash_table_iter_next (&iter, &key, &value))
+	{
+		pInfo = value;
+		if (! _desktop_file_matches_key (pInfo, cKey, iType))
+			continue;
+		iNbFiles ++;
+		if (pInfo->iPriority < iBestPriority)
+		{
+			iBestPriority = pInfo->iPriority;
+			cBestPath = key;
+		}
+	}
+	
+	GHashTable *pIndex = (iType == CD_DESKTOP_FILES_BY_NAME ? s_hDesktopFilesByName : iType == CD_DESKTOP_FILES_BY_WMCLASS ? s_hDesktopFilesByWmClass : s_hDesktopFilesByCommand);
+	if (cBestPath == NULL)
+		g_hash_table_remove (pIndex, cKey);
+	else if (iType == CD_DESKTOP_FILES_BY_COMMAND && iNbFiles > 1)  // ambiguous key, don't use it.
+		g_hash_table_insert (pIndex, g_strdup (cKey), g_strdup (""));
+	else
+		g_hash_table_insert (pIndex, g_strdup (cKey), g_strdup (cBestPath));
+}
+static void _update_index_keys (CDDesktopFileInfo *pInfo)
+{
+	_update_index_key (pInfo->cFileName, CD_DESKTOP_FILES_BY_NAME);
+	_update_index_key (pInfo->cLowerName, CD_DESKTOP_FILES_BY_NAME);
+	_update_index_key (pInfo->cWmClass, CD_DESKTOP_FILES_BY_WMCLASS);
+	_update_index_key (pInfo->cCommandClass, CD_DESKTOP_FILES_BY_COMMAND);
+}
+static void _update_desktop_file (const gchar *cPath, gint iPriority)
+{
+	if (! s_bDesktopFilesIndexIsValid)  // the index is being built, the file will be updated once it's done.
+	{
+		g_hash_table_insert (s_hPendingDesktopFiles, g_strdup (cPath), GINT_TO_POINTER (iPriority));
+		return;
+	}
+	cd_debug ("update %s in the index", cPath);
+	
+	// replace the previous entry of this file, if any.
+	gpointer key = NULL, value = NULL;
+	CDDesktopFileInfo *pOldInfo = NULL;
+	if (g_hash_table_lookup_extended (s_hDesktopFiles, cPath, &key, &value))
+	{
+		g_hash_table_steal (s_hDesktopFiles, cPath);
+		g_free (key);
+		pOldInfo = value;
+	}
+	CDDesktopFileInfo *pInfo = _read_desktop_file_info (cPath, iPriority);  // NULL if it has been removed.
+	if (pInfo != NULL)
+		g_hash_table_insert (s_hDesktopFiles, g_strdup (cPath), pInfo);
+	
+	// only the keys of this file need to be updated.
+	if (pOldInfo != NULL)
+	{
+		_update_index_keys (pOldInfo);
+		_free_desktop_file_info (pOldInfo);
+	}
+	if (pInfo != NULL)
+		_update_index_keys (pInfo);
+}
+static void _update_desktop_files_in_dir (CDDesktopFilesDir *pDir)  // when a folder appears
+{
+	GDir *dir = g_dir_open (pDir->cDirPath, 0, NULL);
+	if (dir == NULL)
+		return;
+	const gchar *cFileName;
+	while ((cFileName = g_dir_read_name (dir)) != NULL)
+	{
+		if (! g_str_has_suffix (cFileName, ".desktop"))
+			continue;
+		gchar *cPath = g_strdup_printf ("%s/%s", pDir->cDirPath, cFileName);
+		_update_desktop_file (cPath, pDir->iPriority);
+		g_free (cPath);
+	}
+	g_dir_close (dir);
+}
+static void _remove_desktop_files_in_dir (CDDesktopFilesDir *pDir)  // when a folder disappears
+{
+	if (! s_bDesktopFilesIndexIsValid)
+		return;  // the index will be completed with the pending files; the others will be removed as their own events arrive.
+	GSList *pPaths = NULL, *p;
+	GHashTableIter iter;
+	gpointer key, value;
+	g_hash_table_iter_init (&iter, s_hDesktopFiles);
+	while (g_hash_table_iter_next (&iter, &key, &value))
+	{
+		if (((CDDesktopFileInfo*)value)->iPriority == pDir->iPriority)
+			pPaths = g_slist_prepend (pPaths, g_strdup (key));
+	}
+	for (p = pPaths; p != NULL; p = p->next)
+		_update_desktop_file (p->data, pDir->iPriority);  // the file doesn't exist anymore, so it's removed.
+	g_slist_free_full (pPaths, g_free);
+}
+
+  ////////////////
+ /// MONITORS ///
+////////////////
+
+static void _on_desktop_files_changed (GFileMonitor *pMonitor, GFile *pFile, GFile *pOtherFile, GFileMonitorEvent iEventType, CDDesktopFilesDir *pDir);
+static void _monitor_desktop_files_dir (CDDesktopFilesDir *pDir)
+{
+	if (pDir->pMonitor != NULL)
+	{
+		g_file_monitor_cancel (pDir->pMonitor);
+		g_object_unref (pDir->pMonitor);
+		pDir->pMonitor = NULL;
+	}
+	// watch the folder, or its nearest parent while it doesn't exist, so that we notice when it's created.
+	GFile *pFile = g_file_new_for_path (pDir->cDirPath);
+	pDir->bWatchingParent = FALSE;
+	while (! g_file_query_exists (pFile, NULL))
+	{
+		GFile *pParent = g_file_get_parent (pFile);
+		g_object_unref (pFile);
+		if (pParent == NULL)  // can't happen, since '/' exists.
+			return;
+		pFile = pParent;
+		pDir->bWatchingParent = TRUE;
+	}
+	pDir->pMonitor = g_file_monitor_directory (pFile, G_FILE_MONITOR_NONE, NULL, NULL);
+	g_object_unref (pFile);
+	if (pDir->pMonitor != NULL)
+		g_signal_connect (pDir->pMonitor, "changed", G_CALLBACK (_on_desktop_files_changed), pDir);
+}
+static void _on_desktop_files_changed (G_GNUC_UNUSED GFileMonitor *pMonitor, GFile *pFile, GFile *pOtherFile, GFileMonitorEvent iEventType, CDDesktopFilesDir *pDir)
+{
+	if (pDir->bWatchingParent)  // the folder doesn't exist yet; see if it (or one of its parents) has been created.
+	{
+		if (iEventType != G_FILE_MONITOR_EVENT_CREATED && iEventType != G_FILE_MONITOR_EVENT_MOVED)
+			return;
+		_monitor_desktop_files_dir (pDir);
+		if (! pDir->bWatchingParent)  // it's there now, index its content.
+			_update_desktop_files_in_dir (pDir);
+		return;
+	}
+	
+	gchar *cPath = g_file_get_path (pFile);
+	if (cPath == NULL)
+		return;
+	if (iEventType == G_FILE_MONITOR_EVENT_DELETED && strcmp (cPath, pDir->cDirPath) == 0)  // the folder itself has been removed.
+	{
+		_remove_desktop_files_in_dir (pDir);
+		_monitor_desktop_files_dir (pDir);
+	}
+	else if (g_str_has_suffix (cPath, ".desktop"))
+	{
+		switch (iEventType)
+		{
+			case G_FILE_MONITOR_EVENT_CREATED:
+			case G_FILE_MONITOR_EVENT_DELETED:
+			case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:  // rather than CHANGED, which can be emitted several times while the file is written.
+				_update_desktop_file (cPath, pDir->iPriority);
+			break;
+			case G_FILE_MONITOR_EVENT_MOVED:
+				_update_desktop_file (cPath, pDir->iPriority);
+				if (pOtherFile != NULL)
+				{
+					gchar *cOtherPath = g_file_get_path (pOtherFile);
+					if (cOtherPath != NULL && g_str_has_suffix (cOtherPath, ".desktop"))
+						_update_desktop_file (cOtherPath, pDir->iPriority);
+					g_free (cOtherPath);
+				}
+			break;
+			default:
+			break;
+		}
+	}
+	g_free (cPath);
+}
+
+void cairo_dock_start_desktop_files_index (void)
+{
+	if (s_pDesktopFilesDirs != NULL)  // already started.
+		return;
+	
+	// same folders and same priority as before, then the other XDG data folders.
+	GPtrArray *pDirPaths = g_ptr_array_new ();
+	g_ptr_array_add (pDirPaths, g_strdup ("/usr/share/applications"));
+	g_ptr_array_add (pDirPaths, g_strdup ("/usr/share/applications/xfce4"));
+	g_ptr_array_add (pDirPaths, g_strdup ("/usr/share/applications/kde4"));
+	g_ptr_array_add (pDirPaths, g_strdup_printf ("%s/.local/share/applications", g_getenv ("HOME")));
+	const gchar * const *cDataDirs = g_get_system_data_dirs ();
+	int i;
+	for (i = 0; cDataDirs[i] != NULL; i ++)
+	{
+		if (strcmp (cDataDirs[i], "/usr/share") == 0 || strcmp (cDataDirs[i], "/usr/share/") == 0)
+			continue;
+		g_ptr_array_add (pDirPaths, g_strdup_printf ("%s/applications", cDataDirs[i]));
+	}
+	g_ptr_array_add (pDirPaths, NULL);
+	gchar **cDirPaths = (gchar**) g_ptr_array_free (pDirPaths, FALSE);
+	
+	// watch the folders from now on, so that no change is missed while the index is built.
+	s_hPendingDesktopFiles = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	CDDesktopFilesDir *pDir;
+	for (i = 0; cDirPaths[i] != NULL; i ++)
+	{
+		pDir = g_new0 (CDDesktopFilesDir, 1);
+		pDir->cDirPath = g_strdup (cDirPaths[i]);
+		pDir->iPriority = i;
+		_monitor_desktop_files_dir (pDir);
+		s_pDesktopFilesDirs = g_list_append (s_pDesktopFilesDirs, pDir);
+	}
+	
+	// build the index in a thread, reading a few hundreds of files may take a while on a cold cache.
+	CDDesktopFilesIndex *pIndex = g_new0 (CDDesktopFilesIndex, 1);
+	pIndex->cDirPaths = cDirPaths;
+	pIndex->pFiles = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) _free_desktop_file_info);
+	pIndex->pByName = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	pIndex->pByWmClass = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	pIndex->pByCommand = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	s_pDesktopFilesIndexTask = gldi_task_new_full (0,
+		(GldiGetDataAsyncFunc) _build_desktop_files_index,
+		(GldiUpdateSyncFunc) _on_desktop_files_index_built,
+		(GFreeFunc) _free_desktop_files_index,
+		pIndex);
+	gldi_task_launch (s_pDesktopFilesIndexTask);
+}
+
+static gchar *_search_desktop_file_in_dirs (const gchar *cFileName)  // used until the index is ready.
+{
+	gchar *cLowerName = g_ascii_strdown (cFileName, -1);
+	gchar *cPath = NULL;
+	CDDesktopFilesDir *pDir;
+	GList *d;
+	for (d = s_pDesktopFilesDirs; d != NULL && cPath == NULL; d = d->next)
+	{
+		pDir = d->data;
+		cPath = g_strdup_printf ("%s/%s", pDir->cDirPath, cFileName);
+		if (! g_file_test (cPath, G_FILE_TEST_EXISTS))
+		{
+			g_free (cPath);
+			cPath = g_strdup_printf ("%s/%s", pDir->cDirPath, cLowerName);
+			if (! g_file_test (cPath, G_FILE_TEST_EXISTS))
+			{
+				g_free (cPath);
+				cPath = NULL;
+			}
+		}
+	}
+	g_free (cLowerName);
+	return cPath;
+}
+
 static gchar *_search_desktop_file (const gchar *cDesktopFile)  // file, path or even class
 {
 	if (cDesktopFile == NULL)
@@ -1587,51 +2012,46 @@ static gchar *_search_desktop_file (const gchar *cDesktopFile)  // file, path or
 	{
 		return g_strdup (cDesktopFile);
 	}
-
+	
+	cairo_dock_start_desktop_files_index ();  // if it's needed before the manager is loaded.
+	
 	gchar *cDesktopFileName = NULL;
+	gboolean bIsClass = FALSE;
 	if (*cDesktopFile == '/')
 		cDesktopFileName = g_path_get_basename (cDesktopFile);
 	else if (! g_str_has_suffix (cDesktopFile, ".desktop"))
+	{
 		cDesktopFileName = g_strdup_printf ("%s.desktop", cDesktopFile);
-
+		bIsClass = TRUE;
+	}
 	const gchar *cFileName = (cDesktopFileName ? cDesktopFileName : cDesktopFile);
-	gboolean bFound = TRUE;
-	GString *sDesktopFilePath = g_string_new ("");
-	g_string_printf (sDesktopFilePath, "/usr/share/applications/%s", cFileName);
-	if (! g_file_test (sDesktopFilePath->str, G_FILE_TEST_EXISTS))
+	
+	if (! s_bDesktopFilesIndexIsValid)  // the index is not ready yet, look for the file directly; the class will be searched again the next time, since it has no .desktop file.
 	{
-		g_string_printf (sDesktopFilePath, "/usr/share/applications/%c%s", g_ascii_toupper (*cFileName), cFileName+1);  // handle stupid cases like Thunar.desktop
-		if (! g_file_test (sDesktopFilePath->str, G_FILE_TEST_EXISTS))
-		{
-			g_string_printf (sDesktopFilePath, "/usr/share/applications/xfce4/%s", cFileName);
-			if (! g_file_test (sDesktopFilePath->str, G_FILE_TEST_EXISTS))
-			{
-				g_string_printf (sDesktopFilePath, "/usr/share/applications/kde4/%s", cFileName);
-				if (! g_file_test (sDesktopFilePath->str, G_FILE_TEST_EXISTS))
-				{
-					g_string_printf (sDesktopFilePath, "%s/.local/share/applications/%s", g_getenv ("HOME"), cFileName);
-					if (! g_file_test (sDesktopFilePath->str, G_FILE_TEST_EXISTS))
-					{
-						bFound = FALSE;
-					}
-				}
-			}
-		}
+		gchar *cPath = _search_desktop_file_in_dirs (cFileName);
+		g_free (cDesktopFileName);
+		return cPath;
 	}
-	g_free (cDesktopFileName);
-
-	gchar *cResult;
-	if (bFound)
+	
+	// look for the file name
+	const gchar *cPath = g_hash_table_lookup (s_hDesktopFilesByName, cFileName);
+	if (cPath == NULL)
 	{
-		cResult = sDesktopFilePath->str;
-		g_string_free (sDesktopFilePath, FALSE);
+		gchar *cLowerName = g_ascii_strdown (cFileName, -1);
+		cPath = g_hash_table_lookup (s_hDesktopFilesByName, cLowerName);
+		g_free (cLowerName);
 	}
-	else
+	g_free (cDesktopFileName);
+	
+	// if it's a class, look for an application that declares it, or that launches it.
+	if (cPath == NULL && bIsClass)
 	{
-		cResult = NULL;
-		g_string_free (sDesktopFilePath, TRUE);
+		cPath = g_hash_table_lookup (s_hDesktopFilesByWmClass, cDesktopFile);
+		if (cPath == NULL)
+			cPath = g_hash_table_lookup (s_hDesktopFilesByCommand, cDesktopFile);
 	}
-	return cResult;
+	
+	return (cPath != NULL && *cPath != '\0' ? g_strdup (cPath) : NULL);
 }
 
 gchar *cairo_dock_guess_class (const gchar *cCommand, const gchar *cStartupWMClass)
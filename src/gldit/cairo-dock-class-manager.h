@@ -60,6 +60,11 @@ struct _CairoDockClassAppli {
 */
 void cairo_dock_initialize_class_manager (void);
 
+/*
+* Lance l'indexation des fichiers .desktop en arriere-plan, une fois la config lue (elle utilise le pool des taches). Ne fait rien la 2eme fois.
+*/
+void cairo_dock_start_desktop_files_index (void);
+
 /*
 * Fournit la liste de toutes les applis connues du dock appartenant a cette classe.
 * @param cClass la classe.
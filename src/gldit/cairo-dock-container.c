@@ -18,6 +18,7 @@
 */
 
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
 #include <cairo.h>
@@ -141,6 +142,36 @@ static gboolean _set_opacity (GtkWidget *pWidget, G_GNUC_UNUSED cairo_t *ctx, Gl
 	return FALSE ;
 }
 
+static gboolean _on_draw_frame (G_GNUC_UNUSED GtkWidget *pWidget, G_GNUC_UNUSED cairo_t *ctx, GldiContainer *pContainer)
+{
+	pContainer->priv->bAnimationFrameDrawn = TRUE;  // lets the animation loop know that something changed on the screen.
+	if (gldi_profiler_is_enabled ())
+		pContainer->priv->iFrameStartTime = g_get_monotonic_time ();
+	return FALSE;
+}
+
+static gboolean _on_draw_frame_done (G_GNUC_UNUSED GtkWidget *pWidget, G_GNUC_UNUSED cairo_t *ctx, GldiContainer *pContainer)
+{
+	if (gldi_profiler_is_enabled () && pContainer->priv->iFrameStartTime != 0)
+	{
+		gldi_profiler_record_frame (pContainer, g_get_monotonic_time () - pContainer->priv->iFrameStartTime);
+		pContainer->priv->iFrameStartTime = 0;
+	}
+	return FALSE;
+}
+
+static void _on_unmap (G_GNUC_UNUSED GtkWidget *pWidget, GldiContainer *pContainer)
+{
+	if (pContainer->priv->bAnimationOnFrameClock && pContainer->iSidGLAnimation != 0)  // the frame clock won't tick any more -> continue the animation on a timer.
+	{
+		cairo_dock_stop_animation (pContainer);  // removes the tick callback and clears its id.
+		if (pContainer->priv->bInAnimationTick)  // unmapped by the animation loop itself: the tick will relaunch it if the loop continues.
+			pContainer->priv->bRelaunchAnimation = TRUE;
+		else
+			cairo_dock_launch_animation (pContainer);
+	}
+}
+
 static void _remove_background (G_GNUC_UNUSED GtkWidget *pWidget, GldiContainer *pContainer)
 {
 	gdk_window_set_background_pattern (gldi_container_get_gdk_window (pContainer), NULL);  // window must be realized (shown)
@@ -197,6 +228,88 @@ void cairo_dock_redraw_icon (Icon *icon)
 	_redraw_container_area (pContainer, &rect);
 }
 
+GdkRectangle *gldi_container_begin_damage (GldiContainer *pContainer, cairo_t *pCairoContext)
+{
+	int w = (pContainer->bIsHorizontal ? pContainer->iWidth : pContainer->iHeight);  // size of the window
+	int h = (pContainer->bIsHorizontal ? pContainer->iHeight : pContainer->iWidth);
+	double x1, x2, y1, y2;
+	cairo_clip_extents (pCairoContext, &x1, &y1, &x2, &y2);  // GDK has already made the union of the invalidated areas.
+	GdkRectangle *pArea = &pContainer->priv->damageArea;
+	pArea->x = floor (x1);
+	pArea->y = floor (y1);
+	pArea->width = ceil (x2) - pArea->x;
+	pArea->height = ceil (y2) - pArea->y;
+	
+	if (pArea->width <= 0 || pArea->height <= 0
+	|| (double)pArea->width * pArea->height >= .75 * w * h)  // not worth culling, just redraw everything.
+	{
+		memset (pArea, 0, sizeof (GdkRectangle));
+		return NULL;
+	}
+	return pArea;
+}
+
+void gldi_container_end_damage (GldiContainer *pContainer)
+{
+	memset (&pContainer->priv->damageArea, 0, sizeof (GdkRectangle));
+}
+
+gboolean gldi_container_icon_is_damaged (GldiContainer *pContainer, Icon *icon)
+{
+	if (pContainer == NULL || pContainer->priv->damageArea.width == 0)
+		return TRUE;
+	GdkRectangle rect;
+	cairo_dock_compute_icon_area (icon, pContainer, &rect);
+	
+	// the icon can draw beyond its area (indicators, animations), so only cull along the axis of the container, with a margin.
+	int iMargin = icon->fWidth * icon->fScale / 2 + 1;
+	int iMin, iMax;  // along the axis
+	double fCenter;
+	if (pContainer->bIsHorizontal)
+	{
+		iMin = rect.x - iMargin;
+		iMax = rect.x + rect.width + iMargin;
+		fCenter = rect.x + rect.width / 2.;
+	}
+	else
+	{
+		iMin = rect.y - iMargin;
+		iMax = rect.y + rect.height + iMargin;
+		fCenter = rect.y + rect.height / 2.;
+	}
+	
+	// add the label, placed like the views do: centered on the icon and kept inside a horizontal container, or next to the icon in a vertical one.
+	if (icon->label.iWidth != 0)
+	{
+		int iLabelSize = (pContainer->bIsHorizontal ? icon->label.iWidth : icon->label.iHeight);  // along the axis
+		if (pContainer->bIsHorizontal)
+		{
+			if (fCenter + iLabelSize/2 > pContainer->iWidth)  // it overflows on the right.
+				fCenter = pContainer->iWidth - iLabelSize/2;
+			if (fCenter - iLabelSize/2 < 0)  // it overflows on the left.
+				fCenter = iLabelSize/2;
+		}
+		iMin = MIN (iMin, floor (fCenter - iLabelSize/2) - 1);
+		iMax = MAX (iMax, ceil (fCenter + iLabelSize/2) + 1);
+	}
+	
+	if (pContainer->bIsHorizontal)
+	{
+		rect.x = iMin;
+		rect.width = iMax - iMin;
+		rect.y = 0;
+		rect.height = pContainer->iHeight;
+	}
+	else
+	{
+		rect.y = iMin;
+		rect.height = iMax - iMin;
+		rect.x = 0;
+		rect.width = pContainer->iHeight;
+	}
+	return gdk_rectangle_intersect (&rect, &pContainer->priv->damageArea, NULL);
+}
+
 
 void cairo_dock_allow_widget_to_receive_data (GtkWidget *pWidget, GCallback pCallBack, gpointer data)
 {
@@ -486,6 +599,7 @@ static void init_object (GldiObject *obj, gpointer attr)
 	GldiContainer *pContainer = (GldiContainer*)obj;
 	GldiContainerAttr *cattr = (GldiContainerAttr*)attr;
 	
+	pContainer->priv = g_new0 (GldiContainerPrivate, 1);
 	pContainer->iface.animation_loop = _cairo_default_container_animation_loop;
 	pContainer->fRatio = 1;
 	pContainer->bIsHorizontal = TRUE;
@@ -539,6 +653,18 @@ static void init_object (GldiObject *obj, gpointer attr)
 		"realize",
 		G_CALLBACK (_remove_background),
 		pContainer);
+	g_signal_connect (G_OBJECT (pWindow),
+		"draw",
+		G_CALLBACK (_on_draw_frame),
+		pContainer);  // connected before the draw callback of the derived containers, which can stop the emission.
+	g_signal_connect_after (G_OBJECT (pWindow),
+		"draw",
+		G_CALLBACK (_on_draw_frame_done),
+		pContainer);
+	g_signal_connect (G_OBJECT (pWindow),
+		"unmap",
+		G_CALLBACK (_on_unmap),
+		pContainer);
 
 	// remove the resize grip added by gtk3
 	gtk_window_set_has_resize_grip (GTK_WINDOW(pWindow), FALSE);
@@ -555,19 +681,23 @@ static void reset_object (GldiObject *obj)
 	// destroy the opengl context
 	gldi_gl_container_finish (pContainer);
 	
+	// stop the animation loop (before the window, which holds the frame clock)
+	cairo_dock_stop_animation (pContainer);
+	
 	// destroy the window (will remove all signals)
 	gtk_widget_destroy (pContainer->pWidget);
 	pContainer->pWidget = NULL;
 	
-	// stop the animation loop
-	if (pContainer->iSidGLAnimation != 0)
-	{
-		g_source_remove (pContainer->iSidGLAnimation);
-		pContainer->iSidGLAnimation = 0;
-	}
-	
 	if (g_pPrimaryContainer == pContainer)
 		g_pPrimaryContainer = NULL;
+	
+	gldi_profiler_forget_container (pContainer);
+	
+	if (pContainer->priv->bInAnimationTick)  // destroyed by its animation loop; the tick callback has been removed above, and will free the private data once the loop returns.
+		pContainer->priv->bDestroyed = TRUE;
+	else
+		g_free (pContainer->priv);
+	pContainer->priv = NULL;
 }
 
 void gldi_register_containers_manager (void)
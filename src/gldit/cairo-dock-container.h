@@ -162,7 +162,33 @@ struct _GldiContainer {
 	GldiContainerInterface iface;
 	
 	gboolean bIgnoreNextReleaseEvent;
-	gpointer reserved[4];
+	/// private data of the core, in place of a reserved pointer (keep ABI compatibility).
+	GldiContainerPrivate *priv;
+	gpointer reserved[3];
+};
+
+/// Data of a Container that are only used by the core; they are not part of the API and can change at any time.
+struct _GldiContainerPrivate {
+	/// TRUE if the animation loop is driven by the frame clock of the window, FALSE if by a timer.
+	gboolean bAnimationOnFrameClock;
+	/// frame time of the last animation step, in us.
+	gint64 iLastAnimationTime;
+	/// the animation steps are spaced by this factor when nothing is drawn.
+	gint iAnimationSlowdown;
+	/// TRUE if the window has been drawn since the last animation step.
+	gboolean bAnimationFrameDrawn;
+	/// number of animation steps that could not be done in time.
+	guint iNbDroppedFrames;
+	/// TRUE while the animation loop is run by the frame clock.
+	gboolean bInAnimationTick;
+	/// TRUE if the window has been unmapped during the animation tick, the animation continues on a timer.
+	gboolean bRelaunchAnimation;
+	/// TRUE if the container has been destroyed during the animation tick, which then frees this structure.
+	gboolean bDestroyed;
+	/// date when the drawing of the current frame started, if the profiler is enabled.
+	gint64 iFrameStartTime;
+	/// area being redrawn by the current expose, in the window's frame; its width is 0 if the whole container is redrawn.
+	GdkRectangle damageArea;
 };
 
 
@@ -283,6 +309,25 @@ void cairo_dock_redraw_container_area (GldiContainer *pContainer, GdkRectangle *
 */
 void cairo_dock_redraw_icon (Icon *icon);
 
+/** Start a redraw of a Container, taking the area to redraw from the clip of the expose's context (that is to say the union of all the areas that have been invalidated since the last redraw). If the area covers most of the container, the whole container is redrawn instead. Call \ref gldi_container_end_damage when the redraw is done.
+*@param pContainer the Container being redrawn.
+*@param pCairoContext the context given by the expose.
+*@return the area to redraw (to be used as a clip or a scissor), or NULL if the whole container is redrawn.
+*/
+GdkRectangle *gldi_container_begin_damage (GldiContainer *pContainer, cairo_t *pCairoContext);
+
+/** End the redraw started with \ref gldi_container_begin_damage.
+*@param pContainer the Container.
+*/
+void gldi_container_end_damage (GldiContainer *pContainer);
+
+/** Tell if an Icon has to be drawn during the current redraw of its Container, that is to say if it may intersect the area being redrawn. It's always TRUE outside of a redraw, or when the whole container is redrawn. Views don't need to call it, \ref cairo_dock_render_one_icon and \ref cairo_dock_render_one_icon_opengl already do it.
+*@param pContainer the Container of the icon.
+*@param icon the icon.
+*@return TRUE if the icon must be drawn.
+*/
+gboolean gldi_container_icon_is_damaged (GldiContainer *pContainer, Icon *icon);
+
 
 void cairo_dock_allow_widget_to_receive_data (GtkWidget *pWidget, GCallback pCallBack, gpointer data);
 
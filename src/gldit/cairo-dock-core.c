@@ -42,6 +42,7 @@
 #include "cairo-dock-module-manager.h"
 #include "cairo-dock-module-instance-manager.h"
 #include "cairo-dock-packages.h"
+#include "cairo-dock-task.h"
 #include "cairo-dock-style-manager.h"
 #include "cairo-dock-indicator-manager.h"
 #include "cairo-dock-keybinder.h"
@@ -85,6 +86,7 @@ static void _gldi_register_core_managers (void)
 	gldi_register_overlays_manager ();
 	gldi_register_backends_manager ();
 	gldi_register_connection_manager ();
+	gldi_register_tasks_manager ();
 	gldi_register_shortkeys_manager ();
 	gldi_register_data_renderers_manager ();
 	gldi_register_desktop_environment_manager ();
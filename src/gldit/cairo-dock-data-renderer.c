@@ -49,6 +49,34 @@ extern gboolean g_bUseOpenGL;
 #define cairo_dock_set_data_renderer_on_icon(pIcon, pRenderer) (pIcon)->pDataRenderer = pRenderer
 #define CD_MIN_TEXT_WITH 24
 
+static void _resize_values_history (CairoDataToRenderer *pData, int iNewMemorySize)
+{
+	// the history is a ring buffer: unroll it into the new buffer, so that the most recent values are kept in chronological order.
+	int iOldMemorySize = pData->iMemorySize;
+	int iNbKeptValues = (pData->iCurrentIndex < 0 ? 0 : MIN (iOldMemorySize, iNewMemorySize));
+	gdouble *pValuesBuffer = g_new0 (gdouble, iNewMemorySize * pData->iNbValues);
+	int t, k;
+	for (t = 0; t < iNbKeptValues; t ++)  // t = age of the value
+	{
+		k = pData->iCurrentIndex - t;
+		if (k < 0)
+			k += iOldMemorySize;
+		memcpy (&pValuesBuffer[(iNbKeptValues - 1 - t) * pData->iNbValues], pData->pTabValues[k], pData->iNbValues * sizeof (gdouble));
+	}
+	g_free (pData->pValuesBuffer);
+	pData->pValuesBuffer = pValuesBuffer;
+	pData->iMemorySize = iNewMemorySize;
+	
+	g_free (pData->pTabValues);
+	pData->pTabValues = g_new (gdouble *, pData->iMemorySize);
+	int i;
+	for (i = 0; i < pData->iMemorySize; i ++)
+	{
+		pData->pTabValues[i] = &pData->pValuesBuffer[i*pData->iNbValues];
+	}
+	pData->iCurrentIndex = iNbKeptValues - 1;
+}
+
 static void _cairo_dock_init_data_renderer (CairoDataRenderer *pRenderer, CairoDataRendererAttribute *pAttribute)
 {
 	//\_______________ On alloue la structure des donnees.
@@ -558,25 +586,7 @@ void cairo_dock_add_new_data_renderer_on_icon (Icon *pIcon, GldiContainer *pCont
 			
 			pAttribute->iMemorySize = MAX (2, pAttribute->iMemorySize);
 			if (pData->iMemorySize != pAttribute->iMemorySize)  // on redimensionne le tampon des valeurs.
-			{
-				int iOldMemorySize = pData->iMemorySize;
-				pData->iMemorySize = pAttribute->iMemorySize;
-				pData->pValuesBuffer = g_realloc (pData->pValuesBuffer, pData->iMemorySize * pData->iNbValues * sizeof (gdouble));
-				if (pData->iMemorySize > iOldMemorySize)
-				{
-					memset (&pData->pValuesBuffer[iOldMemorySize * pData->iNbValues], 0, (pData->iMemorySize - iOldMemorySize) * pData->iNbValues * sizeof (gdouble));
-				}
-				
-				g_free (pData->pTabValues);
-				pData->pTabValues = g_new (gdouble *, pData->iMemorySize);
-				int i;
-				for (i = 0; i < pData->iMemorySize; i ++)
-				{
-					pData->pTabValues[i] = &pData->pValuesBuffer[i*pData->iNbValues];
-				}
-				if (pData->iCurrentIndex >= pData->iMemorySize)
-					pData->iCurrentIndex = pData->iMemorySize - 1;
-			}
+				_resize_values_history (pData, pAttribute->iMemorySize);
 		}
 		
 		//\_____________ remove the current data-renderer
@@ -641,16 +651,15 @@ static gboolean _render_delayed (Icon *pIcon)
 	pRenderer->iSidRenderIdle = 0;
 	return FALSE;
 }
-void cairo_dock_render_new_data_on_icon (Icon *pIcon, GldiContainer *pContainer, cairo_t *pCairoContext, double *pNewValues)
+
+static void _push_new_values (CairoDataRenderer *pRenderer, double *pNewValues)
 {
-	CairoDataRenderer *pRenderer = cairo_dock_get_icon_data_renderer (pIcon);
-	g_return_if_fail (pRenderer != NULL);
-	
 	//\___________________ On met a jour les valeurs du renderer.
 	CairoDataToRenderer *pData = cairo_data_renderer_get_data (pRenderer);
 	pData->iCurrentIndex ++;
 	if (pData->iCurrentIndex >= pData->iMemorySize)
 		pData->iCurrentIndex -= pData->iMemorySize;
+	pData->iNbPushedValues ++;
 	double fNewValue;
 	int i;
 	for (i = 0; i < pData->iNbValues; i ++)
@@ -666,6 +675,12 @@ void cairo_dock_render_new_data_on_icon (Icon *pIcon, GldiContainer *pContainer,
 		pData->pTabValues[pData->iCurrentIndex][i] = fNewValue;
 	}
 	pData->bHasValue = TRUE;
+}
+
+static void _render_new_data (CairoDataRenderer *pRenderer, Icon *pIcon, GldiContainer *pContainer, cairo_t *pCairoContext)
+{
+	CairoDataToRenderer *pData = cairo_data_renderer_get_data (pRenderer);
+	int i;
 	
 	//\___________________ On met a jour le dessin de l'icone.
 	if (CAIRO_DOCK_CONTAINER_IS_OPENGL (pContainer) && pRenderer->interface.render_opengl)
@@ -717,11 +732,40 @@ void cairo_dock_render_new_data_on_icon (Icon *pIcon, GldiContainer *pContainer,
 		g_free (cBuffer);
 	}
 	
-	cairo_dock_redraw_icon (pIcon);
+	cairo_dock_redraw_icon (pIcon);  // GDK merges the areas invalidated before the next frame.
+}
+
+void cairo_dock_render_new_data_on_icon (Icon *pIcon, GldiContainer *pContainer, cairo_t *pCairoContext, double *pNewValues)
+{
+	CairoDataRenderer *pRenderer = cairo_dock_get_icon_data_renderer (pIcon);
+	g_return_if_fail (pRenderer != NULL);
+	
+	_push_new_values (pRenderer, pNewValues);
+	
+	_render_new_data (pRenderer, pIcon, pContainer, pCairoContext);
+}
+
+void cairo_dock_render_new_data_batch_on_icon (Icon *pIcon, GldiContainer *pContainer, cairo_t *pCairoContext, double *pNewValues, int iNbSamples)
+{
+	CairoDataRenderer *pRenderer = cairo_dock_get_icon_data_renderer (pIcon);
+	g_return_if_fail (pRenderer != NULL && pNewValues != NULL);
+	if (iNbSamples <= 0)
+		return;
+	
+	//\___________________ push all the samples, the oldest first; the icon is drawn only once, with the last one.
+	int iNbValues = cairo_data_renderer_get_nb_values (pRenderer);
+	int k;
+	for (k = 0; k < iNbSamples; k ++)
+	{
+		_push_new_values (pRenderer, &pNewValues[k * iNbValues]);
+	}
+	
+	_render_new_data (pRenderer, pIcon, pContainer, pCairoContext);
 }
 
 
 
+
 void cairo_dock_free_data_renderer (CairoDataRenderer *pRenderer)
 {
 	if (pRenderer == NULL)
@@ -822,23 +866,7 @@ void cairo_dock_resize_data_renderer_history (Icon *pIcon, int iNewMemorySize)
 	if (pData->iMemorySize == iNewMemorySize)
 		return ;
 	
-	int iOldMemorySize = pData->iMemorySize;
-	pData->iMemorySize = iNewMemorySize;
-	pData->pValuesBuffer = g_realloc (pData->pValuesBuffer, pData->iMemorySize * pData->iNbValues * sizeof (gdouble));
-	if (iNewMemorySize > iOldMemorySize)
-	{
-		memset (&pData->pValuesBuffer[iOldMemorySize * pData->iNbValues], 0, (iNewMemorySize - iOldMemorySize) * pData->iNbValues * sizeof (gdouble));
-	}
-	
-	g_free (pData->pTabValues);
-	pData->pTabValues = g_new (gdouble *, pData->iMemorySize);
-	int i;
-	for (i = 0; i < pData->iMemorySize; i ++)
-	{
-		pData->pTabValues[i] = &pData->pValuesBuffer[i*pData->iNbValues];
-	}
-	if (pData->iCurrentIndex >= pData->iMemorySize)
-		pData->iCurrentIndex = pData->iMemorySize - 1;
+	_resize_values_history (pData, iNewMemorySize);
 }
 
 void cairo_dock_refresh_data_renderer (Icon *pIcon, GldiContainer *pContainer)
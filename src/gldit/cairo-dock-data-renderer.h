@@ -62,6 +62,7 @@ struct _CairoDataToRenderer {
 	gdouble *pMinMaxValues;
 	gint iCurrentIndex;
 	gboolean bHasValue;  // TRUE as soon as a value has been set in the history
+	guint iNbPushedValues;  // total number of values pushed in the history, so that a renderer can know how many are new since its last drawing.
 };
 
 #define CAIRO_DOCK_DATA_FORMAT_MAX_LEN 20
@@ -220,6 +221,14 @@ void cairo_dock_add_new_data_renderer_on_icon (Icon *pIcon, GldiContainer *pCont
 *@param pNewValues a set a new values (must be of the size defined on the creation of the Renderer)*/
 void cairo_dock_render_new_data_on_icon (Icon *pIcon, GldiContainer *pContainer, cairo_t *pCairoContext, double *pNewValues);
 
+/**Add several sets of values at once to the Renderer, and draw it only once. This is useful to fill the history after a pause, or when the values come faster than they can be drawn.
+*@param pIcon the icon
+*@param pContainer the icon's container
+*@param pCairoContext a drawing context on the icon
+*@param pNewValues iNbSamples sets of values one after the other, the oldest first (each of the size defined on the creation of the Renderer)
+*@param iNbSamples number of sets of values*/
+void cairo_dock_render_new_data_batch_on_icon (Icon *pIcon, GldiContainer *pContainer, cairo_t *pCairoContext, double *pNewValues, int iNbSamples);
+
 /**Remove the Data Renderer of an icon. All the allocated ressources will be freed.
 *@param pIcon the icon*/
 void cairo_dock_remove_data_renderer_on_icon (Icon *pIcon);
@@ -298,7 +307,7 @@ void cairo_data_renderer_get_size (CairoDataRenderer *pRenderer, gint *iWidth, g
 *@param i the number of the value
 *@param t the time (in number of steps)
 *@return a double*/
-#define cairo_data_renderer_get_value(pRenderer, i, t) pRenderer->data.pTabValues[pRenderer->data.iCurrentIndex+t > pRenderer->data.iMemorySize ? pRenderer->data.iCurrentIndex+t-pRenderer->data.iMemorySize : pRenderer->data.iCurrentIndex+t < 0 ? pRenderer->data.iCurrentIndex+t+pRenderer->data.iMemorySize : pRenderer->data.iCurrentIndex+t][i]
+#define cairo_data_renderer_get_value(pRenderer, i, t) pRenderer->data.pTabValues[pRenderer->data.iCurrentIndex+t >= pRenderer->data.iMemorySize ? pRenderer->data.iCurrentIndex+t-pRenderer->data.iMemorySize : pRenderer->data.iCurrentIndex+t < 0 ? pRenderer->data.iCurrentIndex+t+pRenderer->data.iMemorySize : pRenderer->data.iCurrentIndex+t][i]
 /**Get the current i-th value.
 *@param pRenderer a data renderer
 *@param i the number of the value
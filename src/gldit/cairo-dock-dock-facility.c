@@ -36,6 +36,7 @@
 #include "cairo-dock-desktop-manager.h"  // gldi_desktop_get*
 #include "cairo-dock-data-renderer.h"  // cairo_dock_reload_data_renderer_on_icon
 #include "cairo-dock-opengl.h"  // gldi_gl_container_begin_draw
+#include "cairo-dock-opengl-shader.h"  // gldi_gl_shaders_begin_pass
 
 extern CairoDockGLConfig g_openglConfig;
 #include "cairo-dock-dock-facility.h"
@@ -698,25 +699,36 @@ Icon * cairo_dock_calculate_wave_with_position_linear (GList *pIconList, int x_a
 	double fScale = 0.;
 	double offset = 0.;
 	pointed_ic = (x_abs < 0 ? pIconList : NULL);
-	for (ic = pIconList; ic != NULL; ic = ic->next)
+	
+	// these don't change from one icon to the other; this function is called on each motion of the pointer, on each icon.
+	const double fPhaseFactor = G_PI / myIconsParam.iSinusoidWidth;
+	const double fWaveAmplitude = myIconsParam.fAmplitude * fMagnitude;
+	const double fIconGap = myIconsParam.iIconGap;
+	const int iBaseY = myDocksParam.iDockLineWidth + myDocksParam.iFrameMargin;
+	
+	prev_icon = NULL;
+	for (ic = pIconList; ic != NULL; prev_icon = icon, ic = ic->next)
 	{
 		icon = ic->data;
 		x_cumulated = icon->fXAtRest;
 		fXMiddle = icon->fXAtRest + icon->fWidth / 2;
 
-		//\_______________ We compute its phase (pi/2 next to the cursor).
-		icon->fPhase = (fXMiddle - x_abs) / myIconsParam.iSinusoidWidth * G_PI + G_PI / 2;
-		if (icon->fPhase < 0)
+		//\_______________ We compute its phase (pi/2 next to the cursor), and deduct the sinusoidal amplitude next to the icon (its scale).
+		icon->fPhase = (fXMiddle - x_abs) * fPhaseFactor + G_PI / 2;
+		if (icon->fPhase <= 0)  // outside of the wave (most of the icons of a wide dock), no need to compute the sinus.
 		{
 			icon->fPhase = 0;
+			icon->fScale = 1;
 		}
-		else if (icon->fPhase > G_PI)
+		else if (icon->fPhase >= G_PI)
 		{
 			icon->fPhase = G_PI;
+			icon->fScale = 1;
+		}
+		else
+		{
+			icon->fScale = 1 + fWaveAmplitude * sin (icon->fPhase);
 		}
-		
-		//\_______________ We deduct the sinusoidal amplitude next to the icon (its scale)
-		icon->fScale = 1 + fMagnitude * myIconsParam.fAmplitude * sin (icon->fPhase);
 		if (iWidth > 0 && icon->fInsertRemoveFactor != 0)
 		{
 			fScale = icon->fScale;
@@ -728,7 +740,7 @@ Icon * cairo_dock_calculate_wave_with_position_linear (GList *pIconList, int x_a
 			///offset -= (icon->fWidth * icon->fScale) * (pointed_ic == NULL ? 1 : -1);
 		}
 		
-		icon->fY = (bDirectionUp ? iHeight - myDocksParam.iDockLineWidth - myDocksParam.iFrameMargin - icon->fScale * icon->fHeight : myDocksParam.iDockLineWidth + myDocksParam.iFrameMargin);
+		icon->fY = (bDirectionUp ? iHeight - iBaseY - icon->fScale * icon->fHeight : iBaseY);
 		//g_print ("%s fY : %d; %.2f\n", icon->cName, iHeight, icon->fHeight);
 		
 		/* If we already have defined a pointed icon, we can move the current
@@ -741,15 +753,14 @@ Icon * cairo_dock_calculate_wave_with_position_linear (GList *pIconList, int x_a
 				icon->fX = x_cumulated - 1. * (fFlatDockWidth - iWidth) / 2;
 				//g_print ("  outside from the left : icon->fX = %.2f (%.2f)\n", icon->fX, x_cumulated);
 			}
-			else
+			else  // prev_icon is the previous icon in the list, since ic is not the first one.
 			{
-				prev_icon = (ic->prev != NULL ? ic->prev->data : cairo_dock_get_last_icon (pIconList));
-				icon->fX = prev_icon->fX + (prev_icon->fWidth + myIconsParam.iIconGap) * prev_icon->fScale;
+				icon->fX = prev_icon->fX + (prev_icon->fWidth + fIconGap) * prev_icon->fScale;
 
-				if (icon->fX + icon->fWidth * icon->fScale > icon->fXMax - myIconsParam.fAmplitude * fMagnitude * (icon->fWidth + 1.5*myIconsParam.iIconGap) / 8 && iWidth != 0)
+				if (icon->fX + icon->fWidth * icon->fScale > icon->fXMax - fWaveAmplitude * (icon->fWidth + 1.5*fIconGap) / 8 && iWidth != 0)
 				{
 					//g_print ("  we constraint %s (fXMax=%.2f , fX=%.2f\n", prev_icon->cName, prev_icon->fXMax, prev_icon->fX);
-					fDeltaExtremum = icon->fX + icon->fWidth * icon->fScale - (icon->fXMax - myIconsParam.fAmplitude * fMagnitude * (icon->fWidth + 1.5*myIconsParam.iIconGap) / 16);
+					fDeltaExtremum = icon->fX + icon->fWidth * icon->fScale - (icon->fXMax - fWaveAmplitude * (icon->fWidth + 1.5*fIconGap) / 16);
 					if (myIconsParam.fAmplitude != 0)
 						icon->fX -= fDeltaExtremum * (1 - (icon->fScale - 1) / myIconsParam.fAmplitude) * fMagnitude;
 				}
@@ -760,13 +771,13 @@ Icon * cairo_dock_calculate_wave_with_position_linear (GList *pIconList, int x_a
 		
 		//\_______________ We check if we have a pointer on this icon.
 		if (pointed_ic == NULL
-		    && x_cumulated + icon->fWidth + .5*myIconsParam.iIconGap >= x_abs
-		    && x_cumulated - .5*myIconsParam.iIconGap <= x_abs) // we found the pointed icon.
+		    && x_cumulated + icon->fWidth + .5*fIconGap >= x_abs
+		    && x_cumulated - .5*fIconGap <= x_abs) // we found the pointed icon.
 		{
 			pointed_ic = ic;
 			///icon->bPointed = TRUE;
 			icon->bPointed = (x_abs != (int) fFlatDockWidth && x_abs != 0);
-			icon->fX = x_cumulated - (fFlatDockWidth - iWidth) / 2 + (1 - icon->fScale) * (x_abs - x_cumulated + .5*myIconsParam.iIconGap);
+			icon->fX = x_cumulated - (fFlatDockWidth - iWidth) / 2 + (1 - icon->fScale) * (x_abs - x_cumulated + .5*fIconGap);
 			icon->fX = fAlign * iWidth + (icon->fX - fAlign * iWidth) * (1. - fFoldingFactor);
 			//g_print ("  pointed icon: fX = %.2f (%.2f, %d)\n", icon->fX, x_cumulated, icon->bPointed);
 		}
@@ -1431,7 +1442,9 @@ void cairo_dock_make_preview (CairoDock *pDock, const gchar *cPreviewPath)
 		{
 			if (gldi_gl_container_begin_draw (CAIRO_CONTAINER (pDock)))
 			{
+				gldi_gl_shaders_begin_pass ();
 				pDock->pRenderer->render_opengl (pDock);
+				gldi_gl_shaders_end_pass ();
 			}
 			int s = 4;  // 4 channels of 1 byte each (rgba).
 			GLubyte *buffer = (GLubyte *) g_malloc (w * h * s);
@@ -130,18 +130,14 @@ void cairo_dock_freeze_docks (gboolean bFreeze)
 
 static gboolean _on_expose (G_GNUC_UNUSED GtkWidget *pWidget, cairo_t *pCairoContext, CairoDock *pDock)
 {
+	GdkRectangle *pArea = gldi_container_begin_damage (CAIRO_CONTAINER (pDock), pCairoContext);  // icons outside of this area won't be drawn.
 	if (g_bUseOpenGL && pDock->pRenderer->render_opengl != NULL)  // OpenGL rendering
 	{
-		GdkRectangle area;
-		double x1, x2, y1, y2;
-		cairo_clip_extents (pCairoContext, &x1, &y1, &x2, &y2);
-		area.x = x1;
-		area.y = y1;
-		area.width = x2 - x1;
-		area.height = y2 - y1;
-		
-		if (! gldi_gl_container_begin_draw_full (CAIRO_CONTAINER (pDock), area.x + area.y != 0 ? &area : NULL, TRUE))
+		if (! gldi_gl_container_begin_draw_full (CAIRO_CONTAINER (pDock), pArea, TRUE))  // the scissor limits the clear and the decorations to the area.
+		{
+			gldi_container_end_damage (CAIRO_CONTAINER (pDock));
 			return FALSE;
+		}
 		
 		if (cairo_dock_is_loading ())
 		{
@@ -175,6 +171,7 @@ static gboolean _on_expose (G_GNUC_UNUSED GtkWidget *pWidget, cairo_t *pCairoCon
 			gldi_object_notify (pDock, NOTIFICATION_RENDER, pDock, pCairoContext);
 		}
 	}
+	gldi_container_end_damage (CAIRO_CONTAINER (pDock));
 	return FALSE;
 }
 
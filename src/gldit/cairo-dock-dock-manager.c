@@ -52,6 +52,7 @@
 #include "cairo-dock-indicator-manager.h"  // myIndicatorsParam.bUseClassIndic
 #include "cairo-dock-style-manager.h"
 #include "cairo-dock-opengl.h"
+#include "cairo-dock-opengl-shader.h"  // gldi_gl_shaders_begin_pass
 #include "cairo-dock-dock-visibility.h"
 #include "cairo-dock-dock-manager.h"
 
@@ -1299,7 +1300,9 @@ static gboolean _render_dock_notification (G_GNUC_UNUSED gpointer pUserData, Cai
 		if (pDock->iFadeCounter != 0 && g_pKeepingBelowBackend != NULL && g_pKeepingBelowBackend->pre_render_opengl)
 			g_pKeepingBelowBackend->pre_render_opengl (pDock, (double) pDock->iFadeCounter / myBackendsParam.iHideNbSteps);
 		
+		gldi_gl_shaders_begin_pass ();  // the icons are drawn with the same program and vertex buffer.
 		pDock->pRenderer->render_opengl (pDock);
+		gldi_gl_shaders_end_pass ();
 		
 		if (pDock->fHideOffset != 0 && g_pHidingBackend != NULL && g_pHidingBackend->post_render_opengl)
 			g_pHidingBackend->post_render_opengl (pDock, pDock->fHideOffset);
@@ -265,27 +265,32 @@ void gldi_dock_hide_if_any_window_overlap_or_show (CairoDock *pDock)
 	_hide_if_any_overlap_or_show (pDock, NULL);
 }
 
+static inline void _get_dock_area (CairoDock *pDock, GtkAllocation *pArea)  // area of the dock on the screen.
+{
+	if (pDock->container.bIsHorizontal)
+	{
+		pArea->width = pDock->iMinDockWidth;
+		pArea->height = pDock->iMinDockHeight;
+		pArea->x = pDock->container.iWindowPositionX + (pDock->container.iWidth - pArea->width)/2;
+		pArea->y = pDock->container.iWindowPositionY + (pDock->container.bDirectionUp ? pDock->container.iHeight - pDock->iMinDockHeight : 0);
+	}
+	else
+	{
+		pArea->width = pDock->iMinDockHeight;
+		pArea->height = pDock->iMinDockWidth;
+		pArea->x = pDock->container.iWindowPositionY + (pDock->container.bDirectionUp ? pDock->container.iHeight - pDock->iMinDockHeight : 0);
+		pArea->y = pDock->container.iWindowPositionX + (pDock->container.iWidth - pArea->height)/2;
+	}
+}
+
 static inline gboolean _window_overlaps_dock (GtkAllocation *pWindowGeometry, gboolean bIsHidden, CairoDock *pDock)
 {
 	if (pWindowGeometry->width != 0 && pWindowGeometry->height != 0)
 	{
-		int iDockX, iDockY, iDockWidth, iDockHeight;
-		if (pDock->container.bIsHorizontal)
-		{
-			iDockWidth = pDock->iMinDockWidth;
-			iDockHeight = pDock->iMinDockHeight;
-			iDockX = pDock->container.iWindowPositionX + (pDock->container.iWidth - iDockWidth)/2;
-			iDockY = pDock->container.iWindowPositionY + (pDock->container.bDirectionUp ? pDock->container.iHeight - pDock->iMinDockHeight : 0);
-		}
-		else
-		{
-			iDockWidth = pDock->iMinDockHeight;
-			iDockHeight = pDock->iMinDockWidth;
-			iDockX = pDock->container.iWindowPositionY + (pDock->container.bDirectionUp ? pDock->container.iHeight - pDock->iMinDockHeight : 0);
-			iDockY = pDock->container.iWindowPositionX + (pDock->container.iWidth - iDockHeight)/2;
-		}
+		GtkAllocation area;
+		_get_dock_area (pDock, &area);
 		
-		if (! bIsHidden && pWindowGeometry->x < iDockX + iDockWidth && pWindowGeometry->x + pWindowGeometry->width > iDockX && pWindowGeometry->y < iDockY + iDockHeight && pWindowGeometry->y + pWindowGeometry->height > iDockY)
+		if (! bIsHidden && pWindowGeometry->x < area.x + area.width && pWindowGeometry->x + pWindowGeometry->width > area.x && pWindowGeometry->y < area.y + area.height && pWindowGeometry->y + pWindowGeometry->height > area.y)
 		{
 			return TRUE;
 		}
@@ -315,7 +320,9 @@ static gboolean _window_is_overlapping_dock (GldiWindowActor *actor, gpointer da
 }
 GldiWindowActor *gldi_dock_search_overlapping_window (CairoDock *pDock)
 {
-	return gldi_windows_find (_window_is_overlapping_dock, pDock);
+	GtkAllocation area;
+	_get_dock_area (pDock, &area);
+	return gldi_windows_find_in_area (&area, _window_is_overlapping_dock, pDock);  // only the windows around the dock are tested.
 }
 
 
@@ -32,6 +32,7 @@
 #include "cairo-dock-overlay.h"
 #include "cairo-dock-style-manager.h"
 #include "cairo-dock-opengl-path.h"
+#include "cairo-dock-opengl-shader.h"
 
 #include "cairo-dock-draw-opengl.h"
 
@@ -169,6 +170,7 @@ void cairo_dock_draw_icon_reflect_opengl (Icon *pIcon, CairoDock *pDock)
 		
 		glEnable(GL_TEXTURE_2D);
 		glBindTexture(GL_TEXTURE_2D, pIcon->image.iTexture);
+		gldi_texture_atlas_reset_binding ();
 		glEnable(GL_BLEND);
 		_cairo_dock_set_blend_alpha ();
 		glTexEnvi (GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
@@ -178,46 +180,57 @@ void cairo_dock_draw_icon_reflect_opengl (Icon *pIcon, CairoDock *pDock)
 		glPolygonMode (GL_FRONT, GL_FILL);
 		glColor4f(1., 1., 1., 1.);
 		
-		glBegin(GL_QUADS);
-		
 		double fReflectAlpha = myIconsParam.fAlbedo * pIcon->fAlpha;
-		if (pDock->container.bIsHorizontal)
+		if (gldi_gl_shaders_are_loaded ())
 		{
-			glTexCoord2f (x0, y0);
-			glColor4f (1., 1., 1., fReflectAlpha * pIcon->fReflectShading);
-			glVertex3f (-.5, .5, 0.);  // Bottom Left Of The Texture and Quad
-			
-			glTexCoord2f (x1, y0);
-			glColor4f (1., 1., 1., fReflectAlpha * pIcon->fReflectShading);
-			glVertex3f (.5, .5, 0.);  // Bottom Right Of The Texture and Quad
-			
-			glTexCoord2f (x1, y1);
-			glColor4f (1., 1., 1., fReflectAlpha);
-			glVertex3f (.5, -.5, 0.);  // Top Right Of The Texture and Quad
-			
-			glTexCoord2f (x0, y1);
-			glColor4f (1., 1., 1., fReflectAlpha);
-			glVertex3f (-.5, -.5, 0.);  // Top Left Of The Texture and Quad
+			double fShadedAlpha = fReflectAlpha * pIcon->fReflectShading;
+			if (pDock->container.bIsHorizontal)  // from fReflectAlpha at the top to fShadedAlpha at the bottom.
+				gldi_gl_shader_draw_image_full (&pIcon->image, 1., 1., x0, y0, x1 - x0, y1 - y0, (fReflectAlpha + fShadedAlpha) / 2, 0., fShadedAlpha - fReflectAlpha);
+			else  // from fShadedAlpha on the left to fReflectAlpha on the right.
+				gldi_gl_shader_draw_image_full (&pIcon->image, 1., 1., x0, y0, x1 - x0, y1 - y0, (fReflectAlpha + fShadedAlpha) / 2, fReflectAlpha - fShadedAlpha, 0.);
 		}
 		else
 		{
-			glTexCoord2f (x0, y0);
-			glColor4f (1., 1., 1., fReflectAlpha * pIcon->fReflectShading);
-			glVertex3f (-.5, .5, 0.);  // Bottom Left Of The Texture and Quad
+			glBegin(GL_QUADS);
+			
+			if (pDock->container.bIsHorizontal)
+			{
+				glTexCoord2f (x0, y0);
+				glColor4f (1., 1., 1., fReflectAlpha * pIcon->fReflectShading);
+				glVertex3f (-.5, .5, 0.);  // Bottom Left Of The Texture and Quad
+			
+				glTexCoord2f (x1, y0);
+				glColor4f (1., 1., 1., fReflectAlpha * pIcon->fReflectShading);
+				glVertex3f (.5, .5, 0.);  // Bottom Right Of The Texture and Quad
+			
+				glTexCoord2f (x1, y1);
+				glColor4f (1., 1., 1., fReflectAlpha);
+				glVertex3f (.5, -.5, 0.);  // Top Right Of The Texture and Quad
+			
+				glTexCoord2f (x0, y1);
+				glColor4f (1., 1., 1., fReflectAlpha);
+				glVertex3f (-.5, -.5, 0.);  // Top Left Of The Texture and Quad
+			}
+			else
+			{
+				glTexCoord2f (x0, y0);
+				glColor4f (1., 1., 1., fReflectAlpha * pIcon->fReflectShading);
+				glVertex3f (-.5, .5, 0.);  // Bottom Left Of The Texture and Quad
 			
-			glTexCoord2f (x1, y0);
-			glColor4f (1., 1., 1., fReflectAlpha);
-			glVertex3f (.5, .5, 0.);  // Bottom Right Of The Texture and Quad
+				glTexCoord2f (x1, y0);
+				glColor4f (1., 1., 1., fReflectAlpha);
+				glVertex3f (.5, .5, 0.);  // Bottom Right Of The Texture and Quad
 			
-			glTexCoord2f (x1, y1);
-			glColor4f (1., 1., 1., fReflectAlpha);
-			glVertex3f (.5, -.5, 0.);  // Top Right Of The Texture and Quad
+				glTexCoord2f (x1, y1);
+				glColor4f (1., 1., 1., fReflectAlpha);
+				glVertex3f (.5, -.5, 0.);  // Top Right Of The Texture and Quad
 			
-			glTexCoord2f (x0, y1);
-			glColor4f (1., 1., 1., fReflectAlpha * pIcon->fReflectShading);
-			glVertex3f (-.5, -.5, 0.);  // Top Left Of The Texture and Quad
+				glTexCoord2f (x0, y1);
+				glColor4f (1., 1., 1., fReflectAlpha * pIcon->fReflectShading);
+				glVertex3f (-.5, -.5, 0.);  // Top Left Of The Texture and Quad
+			}
+			glEnd();
 		}
-		glEnd();
 		
 		glPopMatrix ();
 		if (pDock->pRenderer->bUseStencil && g_openglConfig.bStencilBufferAvailable)
@@ -238,11 +251,21 @@ void cairo_dock_draw_icon_opengl (Icon *pIcon, CairoDock *pDock)
 		_cairo_dock_set_blend_pbuffer ();
 	else
 		_cairo_dock_set_blend_alpha ();
-	_cairo_dock_apply_texture_at_size_with_alpha (pIcon->image.iTexture, fSizeX, fSizeY, pIcon->fAlpha);
+	_cairo_dock_set_alpha (pIcon->fAlpha);
+	if (gldi_gl_shaders_are_loaded ())
+	{
+		gldi_gl_shader_draw_image (&pIcon->image, fSizeX, fSizeY, pIcon->fAlpha);
+	}
+	else
+	{
+		cairo_dock_bind_image_buffer_texture (&pIcon->image);  // icons are often in the same atlas, so consecutive icons don't need to bind a new texture.
+		_cairo_dock_apply_current_image_buffer_texture_at_size_with_offset (&pIcon->image, fSizeX, fSizeY, 0., 0.);
+	}
 	//if (g_strcmp0 (pIcon->cName, "Calculatrice") == 0)
 		//g_print ("%s: %.2f\n", pIcon->cName, pIcon->fAlpha);
 	//\_____________________ On dessine son reflet.
 	cairo_dock_draw_icon_reflect_opengl (pIcon, pDock);
+	gldi_gl_shaders_release ();  // the icon and its reflection share the program; the other notifications may use the fixed pipeline.
 	
 	_cairo_dock_disable_texture ();
 }
@@ -307,6 +330,8 @@ void cairo_dock_render_one_icon_opengl (Icon *icon, CairoDock *pDock, double fDo
 {
 	if (icon->image.iTexture == 0)
 		return ;
+	if (! gldi_container_icon_is_damaged (CAIRO_CONTAINER (pDock), icon))  // outside of the scissor.
+		return ;
 	double fRatio = pDock->container.fRatio;
 	
 	if (g_pGradationTexture[pDock->container.bIsHorizontal] == 0)
@@ -380,6 +405,8 @@ void cairo_dock_render_one_icon_opengl (Icon *icon, CairoDock *pDock, double fDo
 	gboolean bIconHasBeenDrawn = FALSE;
 	gldi_object_notify (&myIconObjectMgr, NOTIFICATION_PRE_RENDER_ICON, icon, pDock, NULL);
 	gldi_object_notify (&myIconObjectMgr, NOTIFICATION_RENDER_ICON, icon, pDock, &bIconHasBeenDrawn, NULL);
+	gldi_texture_atlas_reset_binding ();  // the animations may have bound their own textures.
+	gldi_gl_shaders_release ();  // in case a plugin drew the icon with the shaders itself.
 	
 	glPopMatrix ();  // retour juste apres la translation au milieu de l'icone.
 	
@@ -762,11 +789,13 @@ void cairo_dock_update_icon_texture (Icon *pIcon)
 		_cairo_dock_set_blend_source ();
 		_cairo_dock_set_alpha (1.);  // full white
 		
+		gldi_texture_atlas_remove_image (&pIcon->image);
 		if (pIcon->image.iTexture == 0)
 			glGenTextures (1, &pIcon->image.iTexture);
 		int w = cairo_image_surface_get_width (pIcon->image.pSurface);
 		int h = cairo_image_surface_get_height (pIcon->image.pSurface);
 		glBindTexture (GL_TEXTURE_2D, pIcon->image.iTexture);
+		gldi_texture_atlas_reset_binding ();
 		
 		glTexParameteri (GL_TEXTURE_2D,
 			GL_TEXTURE_MIN_FILTER,
@@ -823,7 +852,8 @@ void cairo_dock_apply_icon_texture_at_current_size (Icon *pIcon, GldiContainer *
 	double fSizeX, fSizeY;
 	cairo_dock_get_current_icon_size (pIcon, pContainer, &fSizeX, &fSizeY);
 	
-	_cairo_dock_apply_texture_at_size (pIcon->image.iTexture, fSizeX, fSizeY);
+	cairo_dock_bind_image_buffer_texture (&pIcon->image);
+	_cairo_dock_apply_current_image_buffer_texture_at_size_with_offset (&pIcon->image, fSizeX, fSizeY, 0., 0.);
 }
 
 void cairo_dock_draw_icon_texture (Icon *pIcon, GldiContainer *pContainer)
@@ -890,6 +920,7 @@ void cairo_dock_draw_hidden_appli_icon (Icon *pIcon, GldiContainer *pContainer,
 		if (pIcon->pAppli->bIsHidden)
 		{
 			iOriginalTexture = pIcon->image.iTexture;
+			gldi_texture_atlas_remove_image (&pIcon->image);
 			pIcon->image.iTexture = cairo_dock_create_texture_from_surface (pIcon->image.pSurface);
 			/// Using FBOs copies the texture data (pixels) within VRAM only:
 			/// - setup & bind FBO
@@ -28,6 +28,7 @@
 #include "cairo-dock-struct.h"
 #include "cairo-dock-opengl.h"
 #include "cairo-dock-container.h"
+#include "cairo-dock-texture-atlas.h"  // gldi_texture_atlas_reset_binding
 
 G_BEGIN_DECLS
 
@@ -175,6 +176,7 @@ void cairo_dock_draw_hidden_appli_icon (Icon *pIcon, GldiContainer *pContainer,
 */
 #define _cairo_dock_apply_texture_at_size(iTexture, w, h) do { \
 	glBindTexture (GL_TEXTURE_2D, iTexture);\
+	gldi_texture_atlas_reset_binding ();\
 	_cairo_dock_apply_current_texture_at_size (w, h); } while (0)
 
 /** Apply a texture centered on the current point and at the given scale.
@@ -524,6 +524,8 @@ gboolean cairo_dock_render_icon_notification (G_GNUC_UNUSED gpointer pUserData,
 
 void cairo_dock_render_one_icon (Icon *icon, CairoDock *pDock, cairo_t *pCairoContext, double fDockMagnitude, gboolean bUseText)
 {
+	if (! gldi_container_icon_is_damaged (CAIRO_CONTAINER (pDock), icon))  // outside of the area being redrawn, it would be clipped anyway.
+		return;
 	int iWidth = pDock->container.iWidth;
 	double fRatio = pDock->container.fRatio;
 	gboolean bDirectionUp = pDock->container.bDirectionUp;
@@ -37,6 +37,7 @@
 #include "cairo-dock-icon-facility.h"
 #include "cairo-dock-data-renderer.h"
 #include "cairo-dock-overlay.h"
+#include "cairo-dock-text-cache.h"
 #include "cairo-dock-icon-factory.h"
 
 extern CairoDockImageBuffer g_pIconBackgroundBuffer;
@@ -90,6 +91,31 @@ gboolean cairo_dock_apply_icon_background_opengl (Icon *icon)
 	return FALSE;
 }
 
+void cairo_dock_apply_icon_background (Icon *icon)
+{
+	icon->bNeedApplyBackground = FALSE;
+	if (g_pIconBackgroundBuffer.pSurface != NULL && ! GLDI_OBJECT_IS_SEPARATOR_ICON (icon))
+	{
+		if (icon->image.iTexture != 0 && g_pIconBackgroundBuffer.iTexture != 0)
+		{
+			if (! cairo_dock_apply_icon_background_opengl (icon))  // couldn't draw on the texture
+			{
+				icon->bDamaged = FALSE;  // it's not a big deal, since we can draw under the existing image easily; so we don't need to damage the icon (it's expensive especially if it's an applet).
+				icon->bNeedApplyBackground = TRUE;  // just postpone it until drawing is possible.
+			}
+		}
+		else if (icon->image.pSurface != NULL)
+		{
+			cairo_t *pCairoIconBGContext = cairo_create (icon->image.pSurface);
+			cairo_set_operator (pCairoIconBGContext, CAIRO_OPERATOR_DEST_OVER);
+			cairo_dock_apply_image_buffer_surface_at_size (&g_pIconBackgroundBuffer, pCairoIconBGContext,
+				icon->image.iWidth, icon->image.iHeight,
+				0, 0, 1);
+			cairo_destroy (pCairoIconBGContext);
+		}
+	}
+}
+
 void cairo_dock_load_icon_image (Icon *icon, G_GNUC_UNUSED GldiContainer *pContainer)
 {
 	if (icon->pContainer == NULL)
@@ -140,27 +166,7 @@ void cairo_dock_load_icon_image (Icon *icon, G_GNUC_UNUSED GldiContainer *pConta
 	}
 	
 	//\_____________ set the background if needed.
-	icon->bNeedApplyBackground = FALSE;
-	if (g_pIconBackgroundBuffer.pSurface != NULL && ! GLDI_OBJECT_IS_SEPARATOR_ICON (icon))
-	{
-		if (icon->image.iTexture != 0 && g_pIconBackgroundBuffer.iTexture != 0)
-		{
-			if (! cairo_dock_apply_icon_background_opengl (icon))  // couldn't draw on the texture
-			{
-				icon->bDamaged = FALSE;  // it's not a big deal, since we can draw under the existing image easily; so we don't need to damage the icon (it's expensive especially if it's an applet).
-				icon->bNeedApplyBackground = TRUE;  // just postpone it until drawing is possible.
-			}
-		}
-		else if (icon->image.pSurface != NULL)
-		{
-			cairo_t *pCairoIconBGContext = cairo_create (icon->image.pSurface);
-			cairo_set_operator (pCairoIconBGContext, CAIRO_OPERATOR_DEST_OVER);
-			cairo_dock_apply_image_buffer_surface_at_size (&g_pIconBackgroundBuffer, pCairoIconBGContext,
-				icon->image.iWidth, icon->image.iHeight,
-				0, 0, 1);
-			cairo_destroy (pCairoIconBGContext);
-		}
-	}
+	cairo_dock_apply_icon_background (icon);
 	
 	//\______________ free the previous buffers.
 	if (pPrevSurface != NULL)
@@ -192,12 +198,11 @@ void cairo_dock_load_icon_text (Icon *icon)
 		cTruncatedName = cairo_dock_cut_string (icon->cName, myTaskbarParam.iAppliMaxNameLength);
 	}
 	
-	int iWidth, iHeight;
-	cairo_surface_t *pSurface = cairo_dock_create_surface_from_text ((cTruncatedName != NULL ? cTruncatedName : icon->cName),
+	gldi_text_cache_load_image_buffer (&icon->label,
+		(cTruncatedName != NULL ? cTruncatedName : icon->cName),
 		&myIconsParam.iconTextDescription,
-		&iWidth,
-		&iHeight);
-	cairo_dock_load_image_buffer_from_surface (&icon->label, pSurface, iWidth, iHeight);
+		1.,
+		0);  // names often come back (a window title that toggles), so don't render them again.
 	g_free (cTruncatedName);
 }
 
@@ -214,13 +219,11 @@ void cairo_dock_load_icon_quickinfo (Icon *icon)
 		double fMaxScale = cairo_dock_get_icon_max_scale (icon);
 		if (iHeight / (myIconsParam.quickInfoTextDescription.iSize * fMaxScale) > 5)  // if the icon is very height (the text occupies less than 20% of the icon)
 			fMaxScale = MIN ((double)iHeight / (myIconsParam.quickInfoTextDescription.iSize * 5), MAX (1., 16./myIconsParam.quickInfoTextDescription.iSize) * fMaxScale);  // let's make it use 20% of the icon's height, limited to 16px
-		int w, h;
-		cairo_surface_t *pSurface = cairo_dock_create_surface_from_text_full (icon->cQuickInfo,
+		CairoOverlay *pOverlay = cairo_dock_add_overlay_from_text (icon, icon->cQuickInfo,
 			&myIconsParam.quickInfoTextDescription,
 			fMaxScale,
 			iWidth,  // limit the text to the width of the icon
-			&w, &h);
-		CairoOverlay *pOverlay = cairo_dock_add_overlay_from_surface (icon, pSurface, w, h, CAIRO_OVERLAY_BOTTOM, (gpointer)"quick-info");  // the constant string "quick-info" is used as a unique identifier for all quick-infos; the surface is taken by the overlay.
+			CAIRO_OVERLAY_BOTTOM, (gpointer)"quick-info");  // the constant string "quick-info" is used as a unique identifier for all quick-infos; the image comes from the text cache, since counters and clocks often display the same values again.
 		if (pOverlay)
 			cairo_dock_set_overlay_scale (pOverlay, 0);
 	}
@@ -270,6 +270,11 @@ void cairo_dock_add_reflection_to_icon (Icon *pIcon, GldiContainer *pContainer);
 
 gboolean cairo_dock_apply_icon_background_opengl (Icon *icon);
 
+/**Draw the background of the icons (if any) under the image of a given icon. It's done by \ref cairo_dock_load_icon_image, call it if you load the image buffer of the icon by yourself.
+*@param icon the icon.
+*/
+void cairo_dock_apply_icon_background (Icon *icon);
+
 /**Fill the image buffer (surface & texture) of a given icon, according to its type. Set its size if necessary, and fills the reflection buffer for cairo.
 *@param icon the icon.
 *@param pContainer its container.
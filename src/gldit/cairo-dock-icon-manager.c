@@ -49,6 +49,7 @@
 #include "cairo-dock-applet-manager.h"  // GLDI_OBJECT_IS_APPLET_ICON
 #include "cairo-dock-backends-manager.h"  // cairo_dock_foreach_icon_container_renderer
 #include "cairo-dock-style-manager.h"
+#include "cairo-dock-text-cache.h"
 #define _MANAGER_DEF_
 #include "cairo-dock-icon-manager.h"
 
@@ -72,10 +73,16 @@ static GtkIconTheme *s_pIconTheme = NULL;
 static gboolean s_bUseLocalIcons = FALSE;
 static gboolean s_bUseDefaultTheme = TRUE;
 static guint s_iSidReloadTheme = 0;
+static GHashTable *s_hIconPathCache = NULL;  // "size:name" -> path, or NULL if the icon doesn't exist.
+static GFileMonitor *s_pLocalIconsMonitor = NULL;  // watches the local icons folder, to invalidate the cache.
+static gint64 s_iLastIconThemeRescan = 0;  // date (in us) the themes were last checked for new icons, after a name was not found in the cache.
+
+#define ICON_THEME_RESCAN_DELAY 5  // in s, like GTK when it looks up an icon.
 
 static void _cairo_dock_unload_icon_textures (void);
 static void _cairo_dock_unload_icon_theme (void);
 static void _on_icon_theme_changed (GtkIconTheme *pIconTheme, gpointer data);
+static void _on_cached_icon_theme_changed (GtkIconTheme *pIconTheme, gpointer data);
 
 
 void gldi_icons_foreach (GldiIconFunc pFunction, gpointer pUserData)
@@ -221,24 +228,15 @@ gint cairo_dock_search_icon_size (GtkIconSize iIconSize)
 	return MAX (iWidth, iHeight);
 }
 
-gchar *cairo_dock_search_icon_s_path (const gchar *cFileName, gint iDesiredIconSize)
+static void _clear_icon_path_cache (void)
+{
+	if (s_hIconPathCache != NULL)
+		g_hash_table_remove_all (s_hIconPathCache);
+}
+
+static gchar *_search_icon_s_path (const gchar *cFileName, gint iDesiredIconSize)
 {
-	g_return_val_if_fail (cFileName != NULL, NULL);
-	
-	//\_______________________ easy cases: we receive a path.
-	if (*cFileName == '~')
-	{
-		return g_strdup_printf ("%s%s", g_getenv ("HOME"), cFileName+1);
-	}
-	
-	if (*cFileName == '/')
-	{
-		return g_strdup (cFileName);
-	}
-	
 	//\_______________________ check for the presence of suffix and version number.
-	g_return_val_if_fail (s_pIconTheme != NULL, NULL);
-	
 	GString *sIconPath = g_string_new ("");
 	const gchar *cSuffixTab[4] = {".svg", ".png", ".xpm", NULL};
 	gboolean bHasSuffix=FALSE, bFileFound=FALSE, bHasVersion=FALSE;
@@ -341,6 +339,55 @@ gchar *cairo_dock_search_icon_s_path (const gchar *cFileName, gint iDesiredIconS
 	return cIconPath;
 }
 
+gchar *cairo_dock_search_icon_s_path (const gchar *cFileName, gint iDesiredIconSize)
+{
+	g_return_val_if_fail (cFileName != NULL, NULL);
+	
+	//\_______________________ easy cases: we receive a path.
+	if (*cFileName == '~')
+	{
+		return g_strdup_printf ("%s%s", g_getenv ("HOME"), cFileName+1);
+	}
+	
+	if (*cFileName == '/')
+	{
+		return g_strdup (cFileName);
+	}
+	
+	g_return_val_if_fail (s_pIconTheme != NULL, NULL);
+	
+	//\_______________________ look in the cache first; it is cleared whenever the theme or the local icons change.
+	gchar *cKey = g_strdup_printf ("%d:%s", iDesiredIconSize, cFileName);
+	gpointer pCachedPath;
+	if (g_hash_table_lookup_extended (s_hIconPathCache, cKey, NULL, &pCachedPath))
+	{
+		if (pCachedPath != NULL)
+		{
+			g_free (cKey);
+			return g_strdup (pCachedPath);
+		}
+		// we already know that the icon doesn't exist, unless it has been installed since then. Checking it stats every folder of the themes, so it's done once in a while only; if they have changed, the 'changed' signal clears the cache.
+		gint64 iNow = g_get_monotonic_time ();
+		gboolean bRescanned = FALSE;
+		if (iNow - s_iLastIconThemeRescan >= ICON_THEME_RESCAN_DELAY * G_USEC_PER_SEC)
+		{
+			s_iLastIconThemeRescan = iNow;
+			bRescanned = gtk_icon_theme_rescan_if_needed (s_pIconTheme);
+			if (! s_bUseDefaultTheme)  // the default theme is used as a fallback too.
+				bRescanned |= gtk_icon_theme_rescan_if_needed (gtk_icon_theme_get_default ());
+		}
+		if (! bRescanned)
+		{
+			g_free (cKey);
+			return NULL;
+		}
+	}
+	
+	gchar *cIconPath = _search_icon_s_path (cFileName, iDesiredIconSize);
+	g_hash_table_insert (s_hIconPathCache, cKey, g_strdup (cIconPath));
+	return cIconPath;
+}
+
 void cairo_dock_add_path_to_icon_theme (const gchar *cThemePath)
 {
 	if (s_bUseDefaultTheme)
@@ -352,6 +399,7 @@ void cairo_dock_add_path_to_icon_theme (const gchar *cThemePath)
 	gtk_icon_theme_append_search_path (s_pIconTheme,
 		cThemePath);  /// TODO: does it check for unicity ?...
 	gtk_icon_theme_rescan_if_needed (s_pIconTheme);
+	_clear_icon_path_cache ();  // the 'changed' signal is blocked, but names that were not found may be found now.
 	if (s_bUseDefaultTheme)
 	{
 		g_signal_handlers_unblock_matched (s_pIconTheme,
@@ -386,6 +434,7 @@ void cairo_dock_remove_path_from_icon_theme (const gchar *cThemePath)
 		}
 		paths[i-1] = NULL;
 		gtk_icon_theme_set_search_path (s_pIconTheme, (const gchar **)paths, iNbPaths - 1);
+		_clear_icon_path_cache ();
 	}
 	g_strfreev (paths);
 	
@@ -673,13 +722,23 @@ static gboolean _on_icon_theme_changed_idle (G_GNUC_UNUSED gpointer data)
 static void _on_icon_theme_changed (G_GNUC_UNUSED GtkIconTheme *pIconTheme, G_GNUC_UNUSED gpointer data)
 {
 	cd_message ("theme has changed");
+	_clear_icon_path_cache ();
 	// Reload the icons in idle, because this signal is triggered directly by 'gtk_icon_theme_set_search_path()'; so we may end reloading an applet in the middle of its work (ex.: Status-Notifier when the watcher terminates)
 	if (s_iSidReloadTheme == 0)
 		s_iSidReloadTheme = g_idle_add (_on_icon_theme_changed_idle, NULL);
 }
+static void _on_cached_icon_theme_changed (G_GNUC_UNUSED GtkIconTheme *pIconTheme, G_GNUC_UNUSED gpointer data)
+{
+	_clear_icon_path_cache ();  // only the cache depends on this theme, the icons will be reloaded with the current theme if it changes.
+}
+static void _on_local_icons_changed (G_GNUC_UNUSED GFileMonitor *pMonitor, G_GNUC_UNUSED GFile *pFile, G_GNUC_UNUSED GFile *pOtherFile, G_GNUC_UNUSED GFileMonitorEvent iEventType, G_GNUC_UNUSED gpointer data)
+{
+	_clear_icon_path_cache ();
+}
 static void _cairo_dock_load_icon_theme (void)
 {
 	g_return_if_fail (s_pIconTheme == NULL);
+	_clear_icon_path_cache ();
 	if (myIconsParam.cIconTheme == NULL  // no icon theme defined => use the default one.
 	|| strcmp (myIconsParam.cIconTheme, "_Custom Icons_") == 0)  // use custom icons and default theme as fallback
 	{
@@ -687,11 +746,21 @@ static void _cairo_dock_load_icon_theme (void)
 		g_signal_connect (G_OBJECT (s_pIconTheme), "changed", G_CALLBACK (_on_icon_theme_changed), NULL);
 		s_bUseDefaultTheme = TRUE;
 		s_bUseLocalIcons = (myIconsParam.cIconTheme != NULL);
+		if (s_bUseLocalIcons && g_cCurrentIconsPath != NULL)  // icons can be added into the local folder at any time (by the user, or when importing a theme).
+		{
+			GFile *pFile = g_file_new_for_path (g_cCurrentIconsPath);
+			s_pLocalIconsMonitor = g_file_monitor_directory (pFile, G_FILE_MONITOR_NONE, NULL, NULL);
+			g_object_unref (pFile);
+			if (s_pLocalIconsMonitor != NULL)
+				g_signal_connect (s_pLocalIconsMonitor, "changed", G_CALLBACK (_on_local_icons_changed), NULL);
+		}
 	}
 	else  // use the given icon theme
 	{
 		s_pIconTheme = gtk_icon_theme_new ();
 		gtk_icon_theme_set_custom_theme (s_pIconTheme, myIconsParam.cIconTheme);
+		g_signal_connect (G_OBJECT (s_pIconTheme), "changed", G_CALLBACK (_on_cached_icon_theme_changed), NULL);
+		g_signal_connect (G_OBJECT (gtk_icon_theme_get_default ()), "changed", G_CALLBACK (_on_cached_icon_theme_changed), NULL);  // used as a fallback when searching an icon.
 		s_bUseLocalIcons = FALSE;
 		s_bUseDefaultTheme = FALSE;
 	}
@@ -850,10 +919,20 @@ static void _cairo_dock_unload_icon_textures (void)
 }
 static void _cairo_dock_unload_icon_theme (void)
 {
+	if (s_pLocalIconsMonitor != NULL)
+	{
+		g_file_monitor_cancel (s_pLocalIconsMonitor);
+		g_object_unref (s_pLocalIconsMonitor);
+		s_pLocalIconsMonitor = NULL;
+	}
+	_clear_icon_path_cache ();
 	if (s_bUseDefaultTheme)
 		g_signal_handlers_disconnect_by_func (G_OBJECT(s_pIconTheme), G_CALLBACK(_on_icon_theme_changed), NULL);
 	else
+	{
+		g_signal_handlers_disconnect_by_func (G_OBJECT(gtk_icon_theme_get_default ()), G_CALLBACK(_on_cached_icon_theme_changed), NULL);
 		g_object_unref (s_pIconTheme);
+	}
 	s_pIconTheme = NULL;
 }
 static void unload (void)
@@ -876,6 +955,8 @@ static void unload (void)
 	}
 	
 	_cairo_dock_unload_icon_theme ();
+	
+	gldi_text_cache_clear ();
 }
 
 
@@ -887,6 +968,8 @@ static gboolean on_style_changed (G_GNUC_UNUSED gpointer data)
 {
 	cd_debug ("Icons: style changed to %d", myIconsParam.iconTextDescription.bUseDefaultColors);
 	
+	gldi_text_cache_clear ();  // the default colors are not part of the texts' key.
+	
 	if (myIconsParam.iconTextDescription.cFont == NULL)  // default font -> reload our text description
 	{
 		gldi_text_description_set_font (&myIconsParam.iconTextDescription, NULL);
@@ -917,6 +1000,11 @@ static gboolean on_style_changed (G_GNUC_UNUSED gpointer data)
 
 static void init (void)
 {
+	s_hIconPathCache = g_hash_table_new_full (g_str_hash,
+		g_str_equal,
+		g_free,
+		g_free);
+	
 	gldi_object_register_notification (&myDesktopMgr,
 		NOTIFICATION_DESKTOP_CHANGED,
 		(GldiNotificationFunc) _on_change_current_desktop_viewport_notification,
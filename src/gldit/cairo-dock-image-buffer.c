@@ -27,6 +27,8 @@
 #include "cairo-dock-draw.h"
 #include "cairo-dock-draw-opengl.h"
 #include "cairo-dock-opengl.h"  // gldi_gl_container_make_current
+#include "cairo-dock-image-cache.h"
+#include "cairo-dock-text-cache.h"
 #include "cairo-dock-image-buffer.h"
 
 extern gchar *g_cCurrentThemePath;
@@ -38,6 +40,12 @@ extern CairoDockGLConfig g_openglConfig;
 extern GldiContainer *g_pPrimaryContainer;
 extern gboolean g_bEasterEggs;
 
+// coordinates of a portion of an image in its texture, which can be an atlas (pLocation is the location of the image in the atlas, or NULL).
+#define _atlas_u(pLocation, x) ((pLocation) ? (pLocation)->u + (x) * (pLocation)->du : (x))
+#define _atlas_v(pLocation, y) ((pLocation) ? (pLocation)->v + (y) * (pLocation)->dv : (y))
+#define _atlas_du(pLocation, w) ((pLocation) ? (w) * (pLocation)->du : (w))
+#define _atlas_dv(pLocation, h) ((pLocation) ? (h) * (pLocation)->dv : (h))
+
 
 gchar *cairo_dock_search_image_s_path (const gchar *cImageFile)
 {
@@ -86,18 +94,42 @@ void cairo_dock_load_image_buffer_full (CairoDockImageBuffer *pImage, const gcha
 {
 	if (cImageFile == NULL)
 		return;
+	gldi_texture_atlas_remove_image (pImage);
 	gchar *cImagePath = cairo_dock_search_image_s_path (cImageFile);
 	double w=0, h=0;
-	pImage->pSurface = cairo_dock_create_surface_from_image (
-		cImagePath,
-		1.,
-		iWidth,
-		iHeight,
-		iLoadModifier,
-		&w,
-		&h,
-		&pImage->fZoomX,
-		&pImage->fZoomY);
+	pImage->pSurface = NULL;
+	if (cImagePath != NULL)  // first look in the disk cache, decoding the image (especially a SVG) is much slower.
+		pImage->pSurface = gldi_image_cache_lookup (cImagePath,
+			iWidth,
+			iHeight,
+			iLoadModifier,
+			&w,
+			&h,
+			&pImage->fZoomX,
+			&pImage->fZoomY);
+	if (pImage->pSurface == NULL)
+	{
+		pImage->pSurface = cairo_dock_create_surface_from_image (
+			cImagePath,
+			1.,
+			iWidth,
+			iHeight,
+			iLoadModifier,
+			&w,
+			&h,
+			&pImage->fZoomX,
+			&pImage->fZoomY);
+		if (pImage->pSurface != NULL)
+			gldi_image_cache_store (cImagePath,
+				iWidth,
+				iHeight,
+				iLoadModifier,
+				pImage->pSurface,
+				w,
+				h,
+				pImage->fZoomX,
+				pImage->fZoomY);
+	}
 	pImage->iWidth = w;
 	pImage->iHeight = h;
 	
@@ -150,7 +182,10 @@ void cairo_dock_load_image_buffer_full (CairoDockImageBuffer *pImage, const gcha
 	}
 	
 	if (g_bUseOpenGL)
+	{
 		pImage->iTexture = cairo_dock_create_texture_from_surface (pImage->pSurface);
+		gldi_texture_atlas_add_image (gldi_texture_atlas_get_default (), pImage);
+	}
 	
 	g_free (cImagePath);
 }
@@ -167,12 +202,17 @@ void cairo_dock_load_image_buffer_from_surface (CairoDockImageBuffer *pImage, ca
 	pImage->iHeight = iHeight;
 	pImage->fZoomX = 1.;
 	pImage->fZoomY = 1.;
+	gldi_texture_atlas_remove_image (pImage);
 	if (g_bUseOpenGL)
+	{
 		pImage->iTexture = cairo_dock_create_texture_from_surface (pImage->pSurface);
+		gldi_texture_atlas_add_image (gldi_texture_atlas_get_default (), pImage);
+	}
 }
 
 void cairo_dock_load_image_buffer_from_texture (CairoDockImageBuffer *pImage, GLuint iTexture, int iWidth, int iHeight)
 {
+	gldi_texture_atlas_remove_image (pImage);
 	pImage->iTexture = iTexture;
 	pImage->iWidth = iWidth;
 	pImage->iHeight = iHeight;
@@ -191,6 +231,8 @@ CairoDockImageBuffer *cairo_dock_create_image_buffer (const gchar *cImageFile, i
 
 void cairo_dock_unload_image_buffer (CairoDockImageBuffer *pImage)
 {
+	gldi_texture_atlas_remove_image (pImage);
+	gldi_text_cache_release_image_buffer (pImage);  // the text cache keeps the surface and texture if it's a shared text.
 	if (pImage->pSurface != NULL)
 	{
 		cairo_surface_destroy (pImage->pSurface);
@@ -277,9 +319,10 @@ void cairo_dock_apply_image_buffer_surface_with_offset (const CairoDockImageBuff
 
 void cairo_dock_apply_image_buffer_texture_with_offset (const CairoDockImageBuffer *pImage, double x, double y)
 {
-	glBindTexture (GL_TEXTURE_2D, pImage->iTexture);
+	gldi_texture_atlas_bind_image (pImage);
 	if (cairo_dock_image_buffer_is_animated (pImage))
 	{
+		const GldiTextureAtlasLocation *pLocation = gldi_texture_atlas_get_image_location (pImage);
 		int iFrameWidth = pImage->iWidth / pImage->iNbFrames;
 		
 		int n = (int) pImage->iCurrentFrame;
@@ -288,8 +331,8 @@ void cairo_dock_apply_image_buffer_texture_with_offset (const CairoDockImageBuff
 		_cairo_dock_set_blend_alpha ();
 		
 		_cairo_dock_set_alpha (1. - dn);
-		_cairo_dock_apply_current_texture_portion_at_size_with_offset ((double)n / pImage->iNbFrames, 0,
-			1. / pImage->iNbFrames, 1.,
+		_cairo_dock_apply_current_texture_portion_at_size_with_offset (_atlas_u (pLocation, (double)n / pImage->iNbFrames), _atlas_v (pLocation, 0.),
+			_atlas_du (pLocation, 1. / pImage->iNbFrames), _atlas_dv (pLocation, 1.),
 			iFrameWidth, pImage->iHeight,
 			x, y);
 		
@@ -297,14 +340,14 @@ void cairo_dock_apply_image_buffer_texture_with_offset (const CairoDockImageBuff
 		if (n2 >= pImage->iNbFrames)
 			n2  = 0;
 		_cairo_dock_set_alpha (dn);
-		_cairo_dock_apply_current_texture_portion_at_size_with_offset ((double)n2 / pImage->iNbFrames, 0,
-			1. / pImage->iNbFrames, 1.,
+		_cairo_dock_apply_current_texture_portion_at_size_with_offset (_atlas_u (pLocation, (double)n2 / pImage->iNbFrames), _atlas_v (pLocation, 0.),
+			_atlas_du (pLocation, 1. / pImage->iNbFrames), _atlas_dv (pLocation, 1.),
 			iFrameWidth, pImage->iHeight,
 			x, y);
 	}
 	else
 	{
-		_cairo_dock_apply_current_texture_at_size_with_offset (pImage->iWidth, pImage->iHeight, x, y);
+		_cairo_dock_apply_current_image_buffer_texture_at_size_with_offset (pImage, pImage->iWidth, pImage->iHeight, x, y);
 	}
 }
 
@@ -352,17 +395,18 @@ void cairo_dock_apply_image_buffer_surface_at_size (const CairoDockImageBuffer *
 
 void cairo_dock_apply_image_buffer_texture_at_size (const CairoDockImageBuffer *pImage, int w, int h, double x, double y)
 {
-	glBindTexture (GL_TEXTURE_2D, pImage->iTexture);
+	gldi_texture_atlas_bind_image (pImage);
 	if (cairo_dock_image_buffer_is_animated (pImage))
 	{
+		const GldiTextureAtlasLocation *pLocation = gldi_texture_atlas_get_image_location (pImage);
 		int n = (int) pImage->iCurrentFrame;
 		double dn = pImage->iCurrentFrame - n;
 		
 		_cairo_dock_set_blend_alpha ();
 		
 		_cairo_dock_set_alpha (1. - dn);
-		_cairo_dock_apply_current_texture_portion_at_size_with_offset ((double)n / pImage->iNbFrames, 0,
-			1. / pImage->iNbFrames, 1.,
+		_cairo_dock_apply_current_texture_portion_at_size_with_offset (_atlas_u (pLocation, (double)n / pImage->iNbFrames), _atlas_v (pLocation, 0.),
+			_atlas_du (pLocation, 1. / pImage->iNbFrames), _atlas_dv (pLocation, 1.),
 			w, h,
 			x, y);
 		
@@ -370,14 +414,14 @@ void cairo_dock_apply_image_buffer_texture_at_size (const CairoDockImageBuffer *
 		if (n2 >= pImage->iNbFrames)
 			n2  = 0;
 		_cairo_dock_set_alpha (dn);
-		_cairo_dock_apply_current_texture_portion_at_size_with_offset ((double)n2 / pImage->iNbFrames, 0,
-			1. / pImage->iNbFrames, 1.,
+		_cairo_dock_apply_current_texture_portion_at_size_with_offset (_atlas_u (pLocation, (double)n2 / pImage->iNbFrames), _atlas_v (pLocation, 0.),
+			_atlas_du (pLocation, 1. / pImage->iNbFrames), _atlas_dv (pLocation, 1.),
 			w, h,
 			x, y);
 	}
 	else
 	{
-		_cairo_dock_apply_current_texture_at_size_with_offset (w, h, x, y);
+		_cairo_dock_apply_current_image_buffer_texture_at_size_with_offset (pImage, w, h, x, y);
 	}
 }
 
@@ -419,25 +463,27 @@ void cairo_dock_apply_image_buffer_surface_with_offset_and_limit (const CairoDoc
 
 void cairo_dock_apply_image_buffer_texture_with_limit (const CairoDockImageBuffer *pImage, double fAlpha, int iMaxWidth)
 {
-	glBindTexture (GL_TEXTURE_2D, pImage->iTexture);
+	gldi_texture_atlas_bind_image (pImage);
+	const GldiTextureAtlasLocation *pLocation = gldi_texture_atlas_get_image_location (pImage);
 	
 	int w = iMaxWidth, h = pImage->iHeight;
 	double u0 = 0., u1 = (double) w / pImage->iWidth;
+	double v0 = _atlas_v (pLocation, 0.), v1 = _atlas_v (pLocation, 1.);
 	glBegin(GL_QUAD_STRIP);
 	
 	double a = .75;  // 3/4 plain, 1/4 gradation
 	a = (double) (floor ((-.5+a)*w)) / w + .5;
 	glColor4f (1., 1., 1., fAlpha);
-	glTexCoord2f(u0, 0); glVertex3f (-.5*w,  .5*h, 0.);  // top left
-	glTexCoord2f(u0, 1); glVertex3f (-.5*w, -.5*h, 0.);  // bottom left
+	glTexCoord2f(_atlas_u (pLocation, u0), v0); glVertex3f (-.5*w,  .5*h, 0.);  // top left
+	glTexCoord2f(_atlas_u (pLocation, u0), v1); glVertex3f (-.5*w, -.5*h, 0.);  // bottom left
 	
-	glTexCoord2f(u1*a, 0); glVertex3f ((-.5+a)*w,  .5*h, 0.);  // top middle
-	glTexCoord2f(u1*a, 1); glVertex3f ((-.5+a)*w, -.5*h, 0.);  // bottom middle
+	glTexCoord2f(_atlas_u (pLocation, u1*a), v0); glVertex3f ((-.5+a)*w,  .5*h, 0.);  // top middle
+	glTexCoord2f(_atlas_u (pLocation, u1*a), v1); glVertex3f ((-.5+a)*w, -.5*h, 0.);  // bottom middle
 	
 	glColor4f (1., 1., 1., 0.);
 	
-	glTexCoord2f(u1, 0); glVertex3f (.5*w,  .5*h, 0.);  // top right
-	glTexCoord2f(u1, 1); glVertex3f (.5*w, -.5*h, 0.);  // bottom right
+	glTexCoord2f(_atlas_u (pLocation, u1), v0); glVertex3f (.5*w,  .5*h, 0.);  // top right
+	glTexCoord2f(_atlas_u (pLocation, u1), v1); glVertex3f (.5*w, -.5*h, 0.);  // bottom right
 	
 	glEnd();
 }
@@ -502,6 +548,7 @@ void cairo_dock_end_draw_image_buffer_cairo (CairoDockImageBuffer *pImage)
 gboolean cairo_dock_begin_draw_image_buffer_opengl (CairoDockImageBuffer *pImage, GldiContainer *pContainer, gint iRenderingMode)
 {
 	int iWidth, iHeight;
+	gldi_texture_atlas_remove_image (pImage);  // its texture is going to change, the copy in the atlas will be outdated.
 	/// TODO: test without FBO and dock when iRenderingMode == 2
 	if (CAIRO_DOCK_IS_DESKLET (pContainer))
 	{
@@ -644,6 +691,7 @@ void cairo_dock_end_draw_image_buffer_opengl (CairoDockImageBuffer *pImage, Gldi
 
 void cairo_dock_image_buffer_update_texture (CairoDockImageBuffer *pImage)
 {
+	gldi_texture_atlas_remove_image (pImage);
 	if (pImage->iTexture == 0)
 	{
 		pImage->iTexture = cairo_dock_create_texture_from_surface (pImage->pSurface);
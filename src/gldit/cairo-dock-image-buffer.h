@@ -26,6 +26,7 @@
 
 #include "cairo-dock-struct.h"
 #include "cairo-dock-surface-factory.h"  // CairoDockLoadImageModifier
+#include "cairo-dock-texture-atlas.h"
 G_BEGIN_DECLS
 
 /**
@@ -134,6 +135,25 @@ void cairo_dock_apply_image_buffer_surface_with_offset (const CairoDockImageBuff
 */
 #define cairo_dock_apply_image_buffer_surface(pImage, pCairoContext) cairo_dock_apply_image_buffer_surface_with_offset (pImage, pCairoContext, 0., 0., 1.)
 
+/** Bind the texture that should be used to draw an ImageBuffer (its own texture, or the atlas it's packed into).
+*@param pImage an ImageBuffer.
+*/
+#define cairo_dock_bind_image_buffer_texture gldi_texture_atlas_bind_image
+
+/** Draw the current texture of an ImageBuffer with an offset and at a given size, taking into account its location in the atlas. The texture must be bound with \ref cairo_dock_bind_image_buffer_texture before.
+*@param pImage an ImageBuffer.
+*@param w width
+*@param h height
+*@param x horizontal offset.
+*@param y vertical offset.
+*/
+#define _cairo_dock_apply_current_image_buffer_texture_at_size_with_offset(pImage, w, h, x, y) do { \
+	const GldiTextureAtlasLocation *_pLocation = gldi_texture_atlas_get_image_location (pImage);\
+	if (_pLocation != NULL)\
+		_cairo_dock_apply_current_texture_portion_at_size_with_offset (_pLocation->u, _pLocation->v, _pLocation->du, _pLocation->dv, w, h, x, y);\
+	else\
+		_cairo_dock_apply_current_texture_at_size_with_offset (w, h, x, y); } while (0)
+
 /** Draw an ImageBuffer with an offset on the current OpenGL context, at the size it was loaded.
 *@param pImage an ImageBuffer.
 *@param x horizontal offset.
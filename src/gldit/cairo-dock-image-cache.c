@@ -0,0 +1,296 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <utime.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <glib/gstdio.h>
+
+#include "cairo-dock-log.h"
+#include "cairo-dock-surface-factory.h"  // cairo_dock_create_blank_surface
+#include "cairo-dock-image-cache.h"
+
+#define GLDI_IMAGE_CACHE_MAGIC 0x43444943  // "CDIC"
+#define GLDI_IMAGE_CACHE_VERSION 1
+#define GLDI_IMAGE_CACHE_MAX_SIZE (32 * 1024 * 1024)  // in bytes; about 2000 icons of 64x64.
+
+// header of an entry, followed by the pixels (premultiplied ARGB, native endianness).
+typedef struct {
+	guint32 iMagic;
+	guint32 iVersion;
+	gint32 iWidth;
+	gint32 iHeight;
+	gint32 iStride;
+	gint32 iReserved;
+	gdouble fImageWidth;
+	gdouble fImageHeight;
+	gdouble fZoomX;
+	gdouble fZoomY;
+	} GldiImageCacheHeader;
+
+typedef struct {
+	gchar *cPath;
+	time_t iDate;
+	goffset iSize;
+	} GldiImageCacheFile;
+
+static gchar *s_cCacheDir = NULL;
+static goffset s_iCacheSize = -1;  // total size of the entries, -1 until the cache has been checked; it's updated as entries are stored.
+
+
+static const gchar *_get_cache_dir (void)
+{
+	if (s_cCacheDir == NULL)
+		s_cCacheDir = g_build_filename (g_get_user_cache_dir (), "cairo-dock", "images", NULL);
+	return s_cCacheDir;
+}
+
+static gchar *_get_entry_path (const gchar *cImagePath, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier)
+{
+	// the entry depends on the file itself: if it's modified or replaced, we'll just miss the old entry.
+	GStatBuf st;
+	if (g_stat (cImagePath, &st) != 0)
+		return NULL;
+	gchar *cKey = g_strdup_printf ("%s|%lu|%ld|%lld|%dx%d|%d",
+		cImagePath,
+		(gulong) st.st_ino,
+		(glong) st.st_mtime,
+		(long long) st.st_size,
+		iWidthConstraint, iHeightConstraint,
+		iLoadingModifier);
+	gchar *cHash = g_compute_checksum_for_string (G_CHECKSUM_SHA1, cKey, -1);
+	gchar *cEntryPath = g_build_filename (_get_cache_dir (), cHash, NULL);
+	g_free (cHash);
+	g_free (cKey);
+	return cEntryPath;
+}
+
+cairo_surface_t *gldi_image_cache_lookup (const gchar *cImagePath, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY)
+{
+	g_return_val_if_fail (cImagePath != NULL, NULL);
+	gchar *cEntryPath = _get_entry_path (cImagePath, iWidthConstraint, iHeightConstraint, iLoadingModifier);
+	if (cEntryPath == NULL)
+		return NULL;
+	
+	//\_______________ map the entry.
+	cairo_surface_t *pNewSurface = NULL;
+	int fd = open (cEntryPath, O_RDONLY);
+	if (fd < 0)  // not in the cache yet.
+	{
+		g_free (cEntryPath);
+		return NULL;
+	}
+	struct stat st;
+	if (fstat (fd, &st) != 0 || (gsize)st.st_size < sizeof (GldiImageCacheHeader))
+		goto out;
+	gpointer pData = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (pData == MAP_FAILED)
+		goto out;
+	
+	//\_______________ check that it's a valid entry (it could have been truncated, or written by another version).
+	const GldiImageCacheHeader *pHeader = pData;
+	if (pHeader->iMagic == GLDI_IMAGE_CACHE_MAGIC
+	&& pHeader->iVersion == GLDI_IMAGE_CACHE_VERSION
+	&& pHeader->iWidth > 0 && pHeader->iHeight > 0
+	&& pHeader->iStride == cairo_format_stride_for_width (CAIRO_FORMAT_ARGB32, pHeader->iWidth)
+	&& (gsize)st.st_size == sizeof (GldiImageCacheHeader) + (gsize)pHeader->iStride * pHeader->iHeight)
+	{
+		//\_______________ copy the pixels into a surface suitable for the current rendering mode.
+		cairo_surface_t *pMappedSurface = cairo_image_surface_create_for_data ((guchar*)pData + sizeof (GldiImageCacheHeader),
+			CAIRO_FORMAT_ARGB32,
+			pHeader->iWidth,
+			pHeader->iHeight,
+			pHeader->iStride);
+		pNewSurface = cairo_dock_create_blank_surface (pHeader->iWidth, pHeader->iHeight);
+		cairo_t *pCairoContext = cairo_create (pNewSurface);
+		cairo_set_operator (pCairoContext, CAIRO_OPERATOR_SOURCE);
+		cairo_set_source_surface (pCairoContext, pMappedSurface, 0, 0);
+		cairo_paint (pCairoContext);
+		cairo_destroy (pCairoContext);
+		cairo_surface_destroy (pMappedSurface);
+		
+		*fImageWidth = pHeader->fImageWidth;
+		*fImageHeight = pHeader->fImageHeight;
+		if (fZoomX != NULL)
+			*fZoomX = pHeader->fZoomX;
+		if (fZoomY != NULL)
+			*fZoomY = pHeader->fZoomY;
+		
+		utime (cEntryPath, NULL);  // the entries that are still used are the last ones to be removed.
+	}
+	else
+	{
+		cd_debug ("invalid entry in the image cache (%s)", cEntryPath);
+		g_remove (cEntryPath);
+	}
+	munmap (pData, st.st_size);
+out:
+	close (fd);
+	g_free (cEntryPath);
+	return pNewSurface;
+}
+
+
+static gint _compare_files_date (const GldiImageCacheFile *f1, const GldiImageCacheFile *f2)
+{
+	return (f1->iDate < f2->iDate ? -1 : f1->iDate > f2->iDate ? 1 : 0);
+}
+static void _check_cache_size (void)
+{
+	const gchar *cCacheDir = _get_cache_dir ();
+	GDir *dir = g_dir_open (cCacheDir, 0, NULL);
+	if (dir == NULL)
+		return;
+	
+	//\_______________ list the entries with their size and date of last use.
+	GList *pFiles = NULL;
+	goffset iTotalSize = 0;
+	GStatBuf st;
+	const gchar *cFileName;
+	while ((cFileName = g_dir_read_name (dir)) != NULL)
+	{
+		gchar *cPath = g_build_filename (cCacheDir, cFileName, NULL);
+		if (g_stat (cPath, &st) == 0)
+		{
+			GldiImageCacheFile *pFile = g_new (GldiImageCacheFile, 1);
+			pFile->cPath = cPath;
+			pFile->iDate = st.st_mtime;
+			pFile->iSize = st.st_size;
+			pFiles = g_list_prepend (pFiles, pFile);
+			iTotalSize += st.st_size;
+		}
+		else
+			g_free (cPath);
+	}
+	g_dir_close (dir);
+	
+	//\_______________ if it's too big, remove the oldest entries, so that we don't have to do it again too soon.
+	if (iTotalSize > GLDI_IMAGE_CACHE_MAX_SIZE)
+	{
+		cd_debug ("the image cache is too big (%lld bytes), cleaning it", (long long) iTotalSize);
+		pFiles = g_list_sort (pFiles, (GCompareFunc) _compare_files_date);
+		GList *f;
+		for (f = pFiles; f != NULL && iTotalSize > GLDI_IMAGE_CACHE_MAX_SIZE * 3 / 4; f = f->next)
+		{
+			GldiImageCacheFile *pFile = f->data;
+			if (g_remove (pFile->cPath) == 0)
+				iTotalSize -= pFile->iSize;
+		}
+	}
+	
+	GList *f;
+	for (f = pFiles; f != NULL; f = f->next)
+	{
+		GldiImageCacheFile *pFile = f->data;
+		g_free (pFile->cPath);
+		g_free (pFile);
+	}
+	g_list_free (pFiles);
+	s_iCacheSize = iTotalSize;
+}
+
+void gldi_image_cache_store (const gchar *cImagePath, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, cairo_surface_t *pSurface, double fImageWidth, double fImageHeight, double fZoomX, double fZoomY)
+{
+	g_return_if_fail (cImagePath != NULL && pSurface != NULL);
+	int iWidth = ceil (fImageWidth), iHeight = ceil (fImageHeight);  // size of the surface, since it was loaded with a scale of 1.
+	if (iWidth <= 0 || iHeight <= 0)
+		return;
+	
+	//\_______________ the first time, make sure the cache folder exists; then make sure it's not too big.
+	if (s_iCacheSize < 0)
+	{
+		if (g_mkdir_with_parents (_get_cache_dir (), 7*8*8) != 0)
+		{
+			cd_warning ("couldn't create the image cache in %s", _get_cache_dir ());
+			return;
+		}
+		_check_cache_size ();
+		if (s_iCacheSize < 0)  // couldn't read it.
+			s_iCacheSize = 0;
+	}
+	else if (s_iCacheSize > GLDI_IMAGE_CACHE_MAX_SIZE)  // the count is only an estimation (entries can be replaced or removed), so check the real size before removing anything.
+	{
+		_check_cache_size ();
+	}
+	
+	gchar *cEntryPath = _get_entry_path (cImagePath, iWidthConstraint, iHeightConstraint, iLoadingModifier);
+	if (cEntryPath == NULL)
+		return;
+	
+	//\_______________ get the pixels of the surface (in the cairo mode, it's not an image surface).
+	int iStride = cairo_format_stride_for_width (CAIRO_FORMAT_ARGB32, iWidth);
+	gsize iSize = sizeof (GldiImageCacheHeader) + (gsize)iStride * iHeight;
+	guchar *pBuffer = g_malloc (iSize);
+	
+	GldiImageCacheHeader *pHeader = (GldiImageCacheHeader*)pBuffer;
+	memset (pHeader, 0, sizeof (GldiImageCacheHeader));
+	pHeader->iMagic = GLDI_IMAGE_CACHE_MAGIC;
+	pHeader->iVersion = GLDI_IMAGE_CACHE_VERSION;
+	pHeader->iWidth = iWidth;
+	pHeader->iHeight = iHeight;
+	pHeader->iStride = iStride;
+	pHeader->fImageWidth = fImageWidth;
+	pHeader->fImageHeight = fImageHeight;
+	pHeader->fZoomX = fZoomX;
+	pHeader->fZoomY = fZoomY;
+	
+	cairo_surface_t *pImageSurface = cairo_image_surface_create_for_data (pBuffer + sizeof (GldiImageCacheHeader),
+		CAIRO_FORMAT_ARGB32,
+		iWidth,
+		iHeight,
+		iStride);
+	cairo_t *pCairoContext = cairo_create (pImageSurface);
+	cairo_set_operator (pCairoContext, CAIRO_OPERATOR_SOURCE);
+	cairo_set_source_surface (pCairoContext, pSurface, 0, 0);
+	cairo_paint (pCairoContext);
+	cairo_destroy (pCairoContext);
+	cairo_surface_flush (pImageSurface);
+	gboolean bSuccess = (cairo_surface_status (pImageSurface) == CAIRO_STATUS_SUCCESS);
+	cairo_surface_destroy (pImageSurface);
+	
+	//\_______________ write the entry (atomically, so that a half-written entry is never read).
+	if (bSuccess && g_file_set_contents (cEntryPath, (const gchar*)pBuffer, iSize, NULL))
+		s_iCacheSize += iSize;
+	
+	g_free (pBuffer);
+	g_free (cEntryPath);
+}
+
+
+void gldi_image_cache_clear (void)
+{
+	const gchar *cCacheDir = _get_cache_dir ();
+	GDir *dir = g_dir_open (cCacheDir, 0, NULL);
+	if (dir == NULL)
+		return;
+	const gchar *cFileName;
+	while ((cFileName = g_dir_read_name (dir)) != NULL)
+	{
+		gchar *cPath = g_build_filename (cCacheDir, cFileName, NULL);
+		g_remove (cPath);
+		g_free (cPath);
+	}
+	g_dir_close (dir);
+	if (s_iCacheSize > 0)
+		s_iCacheSize = 0;
+}
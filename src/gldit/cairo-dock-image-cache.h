@@ -0,0 +1,68 @@
+/*
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __CAIRO_DOCK_IMAGE_CACHE__
+#define  __CAIRO_DOCK_IMAGE_CACHE__
+
+#include <glib.h>
+#include <cairo.h>
+
+#include "cairo-dock-struct.h"
+#include "cairo-dock-surface-factory.h"  // CairoDockLoadImageModifier
+G_BEGIN_DECLS
+
+/**
+*@file cairo-dock-image-cache.h This class keeps the images rendered by the dock on the disk, so that they don't have to be decoded again at the next startup (rendering SVG files is especially slow).
+* Each entry is a raw premultiplied ARGB buffer, identified by the path, modification time and size of the original file, plus the size and modifiers it was loaded with; therefore an entry is never used if the original file has been modified.
+* Entries are stored in ~/.cache/cairo-dock/images and are read with mmap. The oldest ones are removed when the cache becomes too big.
+*/
+
+/** Look for an image in the cache.
+*@param cImagePath path of the original image.
+*@param iWidthConstraint width it should be loaded.
+*@param iHeightConstraint height it should be loaded.
+*@param iLoadingModifier modifiers it should be loaded with.
+*@param fImageWidth will be filled with the width of the image.
+*@param fImageHeight will be filled with the height of the image.
+*@param fZoomX if non NULL, will be filled with the zoom that has been applied on width.
+*@param fZoomY if non NULL, will be filled with the zoom that has been applied on height.
+*@return a newly allocated surface, or NULL if the image is not in the cache.
+*/
+cairo_surface_t *gldi_image_cache_lookup (const gchar *cImagePath, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY);
+
+/** Store an image in the cache, as it has been returned by \ref cairo_dock_create_surface_from_image with a scale of 1.
+*@param cImagePath path of the original image.
+*@param iWidthConstraint width it has been loaded.
+*@param iHeightConstraint height it has been loaded.
+*@param iLoadingModifier modifiers it has been loaded with.
+*@param pSurface the surface.
+*@param fImageWidth width of the image.
+*@param fImageHeight height of the image.
+*@param fZoomX zoom that has been applied on width.
+*@param fZoomY zoom that has been applied on height.
+*/
+void gldi_image_cache_store (const gchar *cImagePath, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, cairo_surface_t *pSurface, double fImageWidth, double fImageHeight, double fZoomX, double fZoomY);
+
+/** Remove all the entries of the cache.
+*/
+void gldi_image_cache_clear (void);
+
+G_END_DECLS
+#endif
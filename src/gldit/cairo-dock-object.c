@@ -17,6 +17,8 @@
 * along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <string.h>  // memmove
+
 #include "cairo-dock-struct.h"
 #include "cairo-dock-manager.h"
 #include "cairo-dock-log.h"
@@ -88,12 +90,16 @@ void gldi_object_unref (GldiObject *pObject)
 		
 		// clear notifications
 		GPtrArray *pNotificationsTab = pObject->pNotificationsTab;
+		GldiNotificationTable *pNotificationTable;
 		guint i;
 		for (i = 0; i < pNotificationsTab->len; i ++)
 		{
-			GSList *pNotificationRecordList = g_ptr_array_index (pNotificationsTab, i);
-			g_slist_foreach (pNotificationRecordList, (GFunc)g_free, NULL);
-			g_slist_free (pNotificationRecordList);
+			pNotificationTable = g_ptr_array_index (pNotificationsTab, i);
+			if (pNotificationTable != NULL)
+			{
+				g_free (pNotificationTable->pRecords);
+				g_free (pNotificationTable);
+			}
 		}
 		g_ptr_array_free (pNotificationsTab, TRUE);
 		
@@ -155,19 +161,41 @@ void gldi_object_register_notification (gpointer pObject, GldiNotificationType i
 	g_return_if_fail (pObject != NULL);
 	// grab the notifications tab
 	GPtrArray *pNotificationsTab = GLDI_OBJECT(pObject)->pNotificationsTab;
-	if (!pNotificationsTab || pNotificationsTab->len < iNotifType)
+	if (!pNotificationsTab || pNotificationsTab->len <= iNotifType)
 	{
 		cd_warning ("someone tried to register to an inexisting notification (%d) on an object of type '%s'", iNotifType, gldi_object_get_type(pObject));
 		return ;  // don't try to create/resize the notifications tab, since noone will emit this notification.
 	}
 	
+	// grab the table of this notification, created on the first registration
+	GldiNotificationTable *pNotificationTable = g_ptr_array_index (pNotificationsTab, iNotifType);
+	if (pNotificationTable == NULL)
+	{
+		pNotificationTable = g_new0 (GldiNotificationTable, 1);
+		pNotificationsTab->pdata[iNotifType] = pNotificationTable;
+	}
+	if (pNotificationTable->iNbRecords == pNotificationTable->iSize)
+	{
+		pNotificationTable->iSize = MAX (4, 2 * pNotificationTable->iSize);
+		pNotificationTable->pRecords = g_renew (GldiNotificationRecord, pNotificationTable->pRecords, pNotificationTable->iSize);
+	}
+	
 	// add a record
-	GldiNotificationRecord *pNotificationRecord = g_new (GldiNotificationRecord, 1);
+	GldiNotificationRecord *pNotificationRecord;
+	if (bRunFirst)
+	{
+		memmove (pNotificationTable->pRecords + 1, pNotificationTable->pRecords, pNotificationTable->iNbRecords * sizeof (GldiNotificationRecord));
+		pNotificationRecord = &pNotificationTable->pRecords[0];
+		pNotificationTable->iNbPrepended ++;
+	}
+	else
+	{
+		pNotificationRecord = &pNotificationTable->pRecords[pNotificationTable->iNbRecords];
+	}
 	pNotificationRecord->pFunction = pFunction;
 	pNotificationRecord->pUserData = pUserData;
-	
-	GSList *pNotificationRecordList = g_ptr_array_index (pNotificationsTab, iNotifType);
-	pNotificationsTab->pdata[iNotifType] = (bRunFirst ? g_slist_prepend : g_slist_append) (pNotificationRecordList, pNotificationRecord);
+	pNotificationTable->iNbRecords ++;
+	pNotificationTable->iGeneration ++;
 }
 
 
@@ -176,19 +204,48 @@ void gldi_object_remove_notification (gpointer pObject, GldiNotificationType iNo
 	g_return_if_fail (pObject != NULL);
 	// grab the notifications tab
 	GPtrArray *pNotificationsTab = GLDI_OBJECT(pObject)->pNotificationsTab;
+	g_return_if_fail (pNotificationsTab != NULL && iNotifType < pNotificationsTab->len);
+	GldiNotificationTable *pNotificationTable = g_ptr_array_index (pNotificationsTab, iNotifType);
+	if (pNotificationTable == NULL)
+		return;
 	
 	// remove the record
-	GSList *pNotificationRecordList = g_ptr_array_index (pNotificationsTab, iNotifType);
 	GldiNotificationRecord *pNotificationRecord;
-	GSList *nr;
-	for (nr = pNotificationRecordList; nr != NULL; nr = nr->next)
+	guint i;
+	for (i = 0; i < pNotificationTable->iNbRecords; i ++)
 	{
-		pNotificationRecord = nr->data;
+		pNotificationRecord = &pNotificationTable->pRecords[i];
 		if (pNotificationRecord->pFunction == pFunction && pNotificationRecord->pUserData == pUserData)
 		{
-			pNotificationsTab->pdata[iNotifType] = g_slist_delete_link (pNotificationRecordList, nr);
-			g_free (pNotificationRecord);
+			if (pNotificationTable->iDispatchDepth > 0)  // a dispatch is in progress, don't move the records under its feet; it will skip this one.
+			{
+				pNotificationRecord->pFunction = NULL;
+				pNotificationTable->bHasBlanks = TRUE;
+			}
+			else
+			{
+				memmove (pNotificationRecord, pNotificationRecord + 1, (pNotificationTable->iNbRecords - i - 1) * sizeof (GldiNotificationRecord));
+				pNotificationTable->iNbRecords --;
+			}
+			pNotificationTable->iGeneration ++;
 			break;
 		}
 	}
 }
+
+void gldi_object_compact_notification_table (GldiNotificationTable *pNotificationTable)
+{
+	guint i, j = 0;
+	for (i = 0; i < pNotificationTable->iNbRecords; i ++)
+	{
+		if (pNotificationTable->pRecords[i].pFunction != NULL)
+		{
+			if (j != i)
+				pNotificationTable->pRecords[j] = pNotificationTable->pRecords[i];
+			j ++;
+		}
+	}
+	pNotificationTable->iNbRecords = j;
+	pNotificationTable->bHasBlanks = FALSE;
+	pNotificationTable->iGeneration ++;
+}
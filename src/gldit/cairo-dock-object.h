@@ -22,6 +22,7 @@
 
 #include <glib.h>
 #include "cairo-dock-struct.h"
+#include "cairo-dock-profiler.h"
 
 G_BEGIN_DECLS
 
@@ -117,6 +118,17 @@ typedef struct {
 	gpointer pUserData;
 	} GldiNotificationRecord;
 
+/// Callbacks registered on an object for a given notification, stored contiguously in their calling order.
+typedef struct {
+	GldiNotificationRecord *pRecords;
+	guint iNbRecords;
+	guint iSize;  // allocated size of pRecords
+	guint iGeneration;  // incremented each time the table is modified, so that a dispatch in progress can notice it.
+	guint iNbPrepended;  // number of records inserted at the beginning since the table was created; lets a dispatch in progress keep its position.
+	gint iDispatchDepth;  // number of dispatches in progress on this table; records removed meanwhile are only blanked.
+	gboolean bHasBlanks;  // TRUE if some records have been blanked and need to be removed when the dispatches are over.
+	} GldiNotificationTable;
+
 typedef guint GldiNotificationType;
 
 /// Use this in \ref gldi_object_register_notification to be called before the core.
@@ -148,7 +160,7 @@ typedef guint GldiNotificationType;
 void gldi_object_register_notification (gpointer pObject, GldiNotificationType iNotifType, GldiNotificationFunc pFunction, gboolean bRunFirst, gpointer pUserData);
 
 /** Remove a callback from the list of callbacks of a given object for a given notification and a given data.
-Note: it is safe to remove the callback when it is called, but not another one.
+Note: it is safe to remove a callback while the notification is being broadcasted, including the one that is being called.
 *@param pObject the object (Icon, Container, Manager) for which the action has been registered.
 *@param iNotifType type of the notification.
 *@param pFunction callback.
@@ -157,14 +169,32 @@ Note: it is safe to remove the callback when it is called, but not another one.
 void gldi_object_remove_notification (gpointer pObject, GldiNotificationType iNotifType, GldiNotificationFunc pFunction, gpointer pUserData);
 
 
-#define __notify(pNotificationRecordList, bStop, ...) do {\
+// internal, removes the records that were blanked during a dispatch.
+void gldi_object_compact_notification_table (GldiNotificationTable *pTable);
+
+#define __notify(cObjectType, iNotifType, pTable, bStop, ...) do {\
 	GldiNotificationRecord *pNotificationRecord;\
-	GSList *pElement = pNotificationRecordList, *pNextElement;\
-	while (pElement != NULL && ! bStop) {\
-		pNotificationRecord = pElement->data;\
-		pNextElement = pElement->next;\
-		bStop = pNotificationRecord->pFunction (pNotificationRecord->pUserData, ##__VA_ARGS__);\
-		pElement = pNextElement; }\
+	guint _i, _iGeneration = pTable->iGeneration, _iNbPrepended = pTable->iNbPrepended;\
+	pTable->iDispatchDepth ++;\
+	for (_i = 0; _i < pTable->iNbRecords && ! bStop; _i ++) {\
+		pNotificationRecord = &pTable->pRecords[_i];\
+		if (pNotificationRecord->pFunction == NULL)  /* removed during the dispatch */\
+			continue;\
+		if (gldi_profiler_is_enabled ()) {\
+			GldiNotificationFunc _pFunction = pNotificationRecord->pFunction;  /* the callback can remove itself, or destroy the object */\
+			const gchar *_cObjectType = cObjectType;\
+			gint64 _iStartTime = g_get_monotonic_time ();\
+			bStop = _pFunction (pNotificationRecord->pUserData, ##__VA_ARGS__);\
+			gldi_profiler_record_notification (_cObjectType, iNotifType, _pFunction, g_get_monotonic_time () - _iStartTime); }\
+		else\
+			bStop = pNotificationRecord->pFunction (pNotificationRecord->pUserData, ##__VA_ARGS__);\
+		if (G_UNLIKELY (pTable->iGeneration != _iGeneration)) {  /* the table has been modified by the callback: records inserted before us shift our position */\
+			_i += pTable->iNbPrepended - _iNbPrepended;\
+			_iNbPrepended = pTable->iNbPrepended;\
+			_iGeneration = pTable->iGeneration; }\
+		}\
+	if (-- pTable->iDispatchDepth == 0 && pTable->bHasBlanks)\
+		gldi_object_compact_notification_table (pTable);\
 	} while (0)
 
 #define __notify_on_object(pObject, iNotifType, ...) \
@@ -172,8 +202,9 @@ void gldi_object_remove_notification (gpointer pObject, GldiNotificationType iNo
 	gboolean _stop = FALSE;\
 	GPtrArray *pNotificationsTab = (pObject)->pNotificationsTab;\
 	if (pNotificationsTab && iNotifType < pNotificationsTab->len) {\
-		GSList *pNotificationRecordList = g_ptr_array_index (pNotificationsTab, iNotifType);\
-		__notify (pNotificationRecordList, _stop, ##__VA_ARGS__);} \
+		GldiNotificationTable *pNotificationTable = g_ptr_array_index (pNotificationsTab, iNotifType);\
+		if (pNotificationTable != NULL && pNotificationTable->iNbRecords != 0)  /* fast path: nobody listens to this notification on this object */\
+			__notify (gldi_object_get_type (pObject), iNotifType, pNotificationTable, _stop, ##__VA_ARGS__);} \
 	else {_stop = TRUE;}\
 	_stop; })
 
@@ -31,6 +31,8 @@
 
 #define RADIAN (G_PI / 180.0)  // Conversion Radian/Degres
 #define DELTA_ROUND_DEGREE 3
+#define CD_GLYPHS_TEXTURE_SIZE 512
+#define CD_GLYPH_PADDING 1  // transparent border around each glyph, so that the linear filtering doesn't pick the neighbours.
 
 extern GldiContainer *g_pPrimaryContainer;
 
@@ -176,6 +178,180 @@ CairoDockGLFont *cairo_dock_load_bitmap_font (const gchar *cFontDescription, int
 	return pFont;
 }*/
 
+  ////////////
+ // GLYPHS //
+////////////
+
+typedef struct _CDGlyph {
+	gunichar c;
+	gint iCell;
+	gint iNbColumns;  // 2 for the wide characters (CJK), 1 otherwise.
+	guint iLastDraw;  // stamp of the last text that used it.
+	GList link;  // its place in the LRU queue.
+	} CDGlyph;
+
+typedef struct _CDGlyphCache {
+	PangoFontDescription *pFontDescription;
+	GLuint iTexture;
+	gint iCellWidth, iCellHeight;  // padding included; a cell can hold a wide character.
+	gint iNbCellColumns;
+	gint iNbCells;
+	gint iNbUsedCells;
+	GHashTable *pGlyphs;  // unichar -> CDGlyph
+	GQueue lru;  // most recently used glyph first.
+	cairo_surface_t *pCellSurface;  // where a glyph is rendered before being copied into its cell.
+	guint iDrawStamp;
+	} CDGlyphCache;
+
+static CDGlyphCache *_new_glyph_cache (const gchar *cFontDescription, CairoDockGLFont *pFont)
+{
+	int iCellWidth = ceil (2 * pFont->iCharWidth) + 2 * CD_GLYPH_PADDING;
+	int iCellHeight = ceil (pFont->iCharHeight) + 2 * CD_GLYPH_PADDING;
+	int iNbCellColumns = CD_GLYPHS_TEXTURE_SIZE / iCellWidth;
+	int iNbCellRows = CD_GLYPHS_TEXTURE_SIZE / iCellHeight;
+	if (iNbCellColumns == 0 || iNbCellRows == 0)  // font too big.
+		return NULL;
+	
+	CDGlyphCache *pCache = g_new0 (CDGlyphCache, 1);
+	pCache->pFontDescription = pango_font_description_from_string (cFontDescription);
+	pCache->iCellWidth = iCellWidth;
+	pCache->iCellHeight = iCellHeight;
+	pCache->iNbCellColumns = iNbCellColumns;
+	pCache->iNbCells = iNbCellColumns * iNbCellRows;
+	pCache->pGlyphs = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+	g_queue_init (&pCache->lru);
+	pCache->pCellSurface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, iCellWidth, iCellHeight);
+	return pCache;  // the texture is created when the first glyph is needed; most fonts only draw the characters they were loaded with.
+}
+
+static void _create_glyph_texture (CDGlyphCache *pCache)
+{
+	guchar *pBlank = g_malloc0 (CD_GLYPHS_TEXTURE_SIZE * CD_GLYPHS_TEXTURE_SIZE * 4);
+	glGenTextures (1, &pCache->iTexture);
+	glBindTexture (GL_TEXTURE_2D, pCache->iTexture);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexImage2D (GL_TEXTURE_2D,
+		0,
+		4,
+		CD_GLYPHS_TEXTURE_SIZE,
+		CD_GLYPHS_TEXTURE_SIZE,
+		0,
+		GL_BGRA,
+		GL_UNSIGNED_BYTE,
+		pBlank);
+	g_free (pBlank);
+}
+
+static void _free_glyph_cache (CDGlyphCache *pCache)
+{
+	if (pCache == NULL)
+		return;
+	pango_font_description_free (pCache->pFontDescription);
+	if (pCache->iTexture != 0)
+		_cairo_dock_delete_texture (pCache->iTexture);
+	g_hash_table_destroy (pCache->pGlyphs);  // the links of the queue are inside the glyphs.
+	cairo_surface_destroy (pCache->pCellSurface);
+	g_free (pCache);
+}
+
+static void _render_glyph (CairoDockGLFont *pFont, CDGlyphCache *pCache, CDGlyph *pGlyph)
+{
+	//\_______________ draw the character in the middle of its place, in white (like the other characters of the font).
+	cairo_t *pCairoContext = cairo_create (pCache->pCellSurface);
+	cairo_set_operator (pCairoContext, CAIRO_OPERATOR_CLEAR);
+	cairo_paint (pCairoContext);
+	cairo_set_operator (pCairoContext, CAIRO_OPERATOR_OVER);
+	
+	gchar str[8];
+	int n = g_unichar_to_utf8 (pGlyph->c, str);
+	PangoLayout *pLayout = pango_cairo_create_layout (pCairoContext);
+	pango_layout_set_font_description (pLayout, pCache->pFontDescription);
+	pango_layout_set_text (pLayout, str, n);
+	
+	PangoRectangle log;
+	pango_layout_get_pixel_extents (pLayout, NULL, &log);
+	cairo_translate (pCairoContext,
+		CD_GLYPH_PADDING + (pGlyph->iNbColumns * pFont->iCharWidth - log.width) / 2 - log.x,
+		CD_GLYPH_PADDING - log.y);
+	cairo_set_source_rgb (pCairoContext, 1., 1., 1.);
+	cairo_move_to (pCairoContext, 0, 0);
+	pango_cairo_show_layout (pCairoContext, pLayout);
+	g_object_unref (pLayout);
+	cairo_destroy (pCairoContext);
+	cairo_surface_flush (pCache->pCellSurface);
+	
+	//\_______________ copy it into its cell.
+	glBindTexture (GL_TEXTURE_2D, pCache->iTexture);
+	glPixelStorei (GL_UNPACK_ROW_LENGTH, cairo_image_surface_get_stride (pCache->pCellSurface) / 4);
+	glTexSubImage2D (GL_TEXTURE_2D,
+		0,
+		(pGlyph->iCell % pCache->iNbCellColumns) * pCache->iCellWidth,
+		(pGlyph->iCell / pCache->iNbCellColumns) * pCache->iCellHeight,
+		pCache->iCellWidth,
+		pCache->iCellHeight,
+		GL_BGRA,
+		GL_UNSIGNED_BYTE,
+		cairo_image_surface_get_data (pCache->pCellSurface));
+	glPixelStorei (GL_UNPACK_ROW_LENGTH, 0);
+}
+
+static CDGlyph *_get_glyph (CairoDockGLFont *pFont, CDGlyphCache *pCache, gunichar c)
+{
+	CDGlyph *pGlyph = g_hash_table_lookup (pCache->pGlyphs, GUINT_TO_POINTER (c));
+	if (pGlyph != NULL)  // already rendered, just move it at the head of the queue.
+	{
+		g_queue_unlink (&pCache->lru, &pGlyph->link);
+		g_queue_push_head_link (&pCache->lru, &pGlyph->link);
+		pGlyph->iLastDraw = pCache->iDrawStamp;
+		return pGlyph;
+	}
+	
+	//\_______________ take a free cell, or the one of the least recently used glyph.
+	if (pCache->iTexture == 0)
+		_create_glyph_texture (pCache);
+	if (pCache->iNbUsedCells < pCache->iNbCells)
+	{
+		pGlyph = g_new0 (CDGlyph, 1);
+		pGlyph->iCell = pCache->iNbUsedCells ++;
+		pGlyph->link.data = pGlyph;
+	}
+	else
+	{
+		GList *pLastLink = g_queue_peek_tail_link (&pCache->lru);
+		pGlyph = pLastLink->data;
+		if (pGlyph->iLastDraw == pCache->iDrawStamp)  // every glyph is used by the current text, we can't replace any of them.
+			return NULL;
+		g_queue_unlink (&pCache->lru, pLastLink);
+		g_hash_table_steal (pCache->pGlyphs, GUINT_TO_POINTER (pGlyph->c));
+	}
+	pGlyph->c = c;
+	pGlyph->iNbColumns = (g_unichar_iswide (c) ? 2 : 1);
+	pGlyph->iLastDraw = pCache->iDrawStamp;
+	_render_glyph (pFont, pCache, pGlyph);
+	
+	g_hash_table_insert (pCache->pGlyphs, GUINT_TO_POINTER (c), pGlyph);
+	g_queue_push_head_link (&pCache->lru, &pGlyph->link);
+	return pGlyph;
+}
+
+// get the next character of a text; bytes that are not valid UTF-8 are taken as Latin-1 characters, like before.
+static inline gunichar _get_next_char (const gchar **str)
+{
+	gunichar c = g_utf8_get_char_validated (*str, -1);
+	if (c == (gunichar)-1 || c == (gunichar)-2)
+	{
+		c = (guchar) **str;
+		*str += 1;
+	}
+	else
+	{
+		*str = g_utf8_next_char (*str);
+	}
+	return c;
+}
+
+
 CairoDockGLFont *cairo_dock_load_textured_font (const gchar *cFontDescription, int first, int count)
 {
 	g_return_val_if_fail (g_pPrimaryContainer != NULL && count > 0, NULL);
@@ -232,6 +408,7 @@ CairoDockGLFont *cairo_dock_load_textured_font (const gchar *cFontDescription, i
 	pFont->iNbColumns = count;
 	pFont->iCharWidth = (double)iWidth / count;
 	pFont->iCharHeight = iHeight;
+	pFont->pGlyphs = _new_glyph_cache (cFontDescription, pFont);
 	
 	cd_debug ("%d char / %d pixels => %.3f", count, iWidth, (double)iWidth / count);
 	return pFont;
@@ -262,6 +439,7 @@ void cairo_dock_free_gl_font (CairoDockGLFont *pFont)
 		glDeleteLists (pFont->iListBase, pFont->iNbChars);
 	if (pFont->iTexture != 0)
 		_cairo_dock_delete_texture (pFont->iTexture);
+	_free_glyph_cache (pFont->pGlyphs);
 	g_free (pFont);
 }
 
@@ -274,15 +452,20 @@ void cairo_dock_get_gl_text_extent (const gchar *cText, CairoDockGLFont *pFont,
 		*iHeight = 0;
 		return ;
 	}
-	int i, w=0, wmax=0, h=pFont->iCharHeight;
-	for (i = 0; cText[i] != '\0'; i ++)
+	int w=0, wmax=0, h=pFont->iCharHeight;
+	gunichar c;
+	const gchar *str = cText;
+	while (*str != '\0')
 	{
-		if (cText[i] == '\n')
+		c = _get_next_char (&str);
+		if (c == '\n')
 		{
 			h += pFont->iCharHeight + 1;
 			wmax = MAX (wmax, w);
 			w = 0;
 		}
+		else if (pFont->pGlyphs != NULL && g_unichar_iswide (c))
+			w += 2 * pFont->iCharWidth;
 		else
 			w += pFont->iCharWidth;
 	}
@@ -292,6 +475,16 @@ void cairo_dock_get_gl_text_extent (const gchar *cText, CairoDockGLFont *pFont,
 }
 
 
+// same quad as _cairo_dock_apply_current_texture_portion_at_size_with_offset.
+static inline void _add_quad (GLfloat *pVertices, GLfloat *pCoords, int i, double u, double v, double du, double dv, double w, double h, double x, double y)
+{
+	GLfloat *vert = &pVertices[8*i], *coord = &pCoords[8*i];
+	coord[0] = u;      coord[1] = v;      vert[0] = x-.5*w; vert[1] = y+.5*h;
+	coord[2] = u+du;   coord[3] = v;      vert[2] = x+.5*w; vert[3] = y+.5*h;
+	coord[4] = u+du;   coord[5] = v+dv;   vert[4] = x+.5*w; vert[5] = y-.5*h;
+	coord[6] = u;      coord[7] = v+dv;   vert[6] = x-.5*w; vert[7] = y-.5*h;
+}
+
 void cairo_dock_draw_gl_text (const guchar *cText, CairoDockGLFont *pFont)
 {
 	int n = strlen ((char *) cText);
@@ -325,29 +518,75 @@ void cairo_dock_draw_gl_text (const guchar *cText, CairoDockGLFont *pFont)
 	}
 	else if (pFont->iTexture != 0)
 	{
-		_cairo_dock_enable_texture ();
-		_cairo_dock_set_blend_pbuffer ();  // rend mieux pour les textes
-		glBindTexture (GL_TEXTURE_2D, pFont->iTexture);
-		double u, v, du=1./pFont->iNbColumns, dv=1./pFont->iNbRows, w=pFont->iCharWidth, h=pFont->iCharHeight, x=.5*w, y=.5*h;
-		int i, j;
-		for (i = 0; i < n; i ++)
+		//\_______________ place the characters, and gather their quads: the ones of the font's texture first, then the ones of the glyphs texture.
+		CDGlyphCache *pCache = pFont->pGlyphs;
+		if (pCache != NULL)
+			pCache->iDrawStamp ++;
+		GLfloat *pVertices = g_new (GLfloat, 2 * n * 8);  // n is an upper bound of the number of characters.
+		GLfloat *pCoords = g_new (GLfloat, 2 * n * 8);
+		int iNbQuads = 0, iNbGlyphQuads = 0;
+		double u, v, du=1./pFont->iNbColumns, dv=1./pFont->iNbRows, w=pFont->iCharWidth, h=pFont->iCharHeight, x=0., y=.5*h;  // x = left of the current character
+		double ww;
+		CDGlyph *pGlyph;
+		gunichar c;
+		const gchar *str = (const gchar *) cText;
+		int j;
+		while (*str != '\0')
 		{
-			if (cText[i] == '\n')
+			c = _get_next_char (&str);
+			if (c == '\n')
 			{
-				x = .5*pFont->iCharWidth;
+				x = 0.;
 				y += pFont->iCharHeight + 1;
 				continue;
 			}
-			if (cText[i] < pFont->iCharBase || cText[i] >= pFont->iCharBase + pFont->iNbChars)
-				continue;
-			
-			j = cText[i] - pFont->iCharBase;
-			u = (double) (j%pFont->iNbColumns) / pFont->iNbColumns;
-			v = (double) (j/pFont->iNbColumns) / pFont->iNbRows;
-			_cairo_dock_apply_current_texture_portion_at_size_with_offset (u, v, du, dv, w, h, x, y);
-			x += pFont->iCharWidth;
+			if (c >= (gunichar)pFont->iCharBase && c < (gunichar)(pFont->iCharBase + pFont->iNbChars))
+			{
+				j = c - pFont->iCharBase;
+				u = (double) (j%pFont->iNbColumns) / pFont->iNbColumns;
+				v = (double) (j/pFont->iNbColumns) / pFont->iNbRows;
+				_add_quad (pVertices, pCoords, iNbQuads, u, v, du, dv, w, h, x + .5*w, y);
+				iNbQuads ++;
+				x += w;
+			}
+			else if (pCache != NULL && (pGlyph = _get_glyph (pFont, pCache, c)) != NULL)
+			{
+				ww = pGlyph->iNbColumns * w;
+				_add_quad (pVertices + n * 8, pCoords + n * 8, iNbGlyphQuads,
+					(double) ((pGlyph->iCell % pCache->iNbCellColumns) * pCache->iCellWidth + CD_GLYPH_PADDING) / CD_GLYPHS_TEXTURE_SIZE,
+					(double) ((pGlyph->iCell / pCache->iNbCellColumns) * pCache->iCellHeight + CD_GLYPH_PADDING) / CD_GLYPHS_TEXTURE_SIZE,
+					ww / CD_GLYPHS_TEXTURE_SIZE,
+					h / CD_GLYPHS_TEXTURE_SIZE,
+					ww, h, x + .5*ww, y);
+				iNbGlyphQuads ++;
+				x += ww;
+			}
+		}
+		
+		//\_______________ draw them, with one call per texture.
+		_cairo_dock_enable_texture ();
+		_cairo_dock_set_blend_pbuffer ();  // rend mieux pour les textes
+		glEnableClientState (GL_VERTEX_ARRAY);
+		glEnableClientState (GL_TEXTURE_COORD_ARRAY);
+		if (iNbQuads != 0)
+		{
+			glBindTexture (GL_TEXTURE_2D, pFont->iTexture);
+			glTexCoordPointer (2, GL_FLOAT, 0, pCoords);
+			glVertexPointer (2, GL_FLOAT, 0, pVertices);
+			glDrawArrays (GL_QUADS, 0, 4 * iNbQuads);
+		}
+		if (iNbGlyphQuads != 0)
+		{
+			glBindTexture (GL_TEXTURE_2D, pCache->iTexture);
+			glTexCoordPointer (2, GL_FLOAT, 0, pCoords + n * 8);
+			glVertexPointer (2, GL_FLOAT, 0, pVertices + n * 8);
+			glDrawArrays (GL_QUADS, 0, 4 * iNbGlyphQuads);
 		}
+		glDisableClientState (GL_TEXTURE_COORD_ARRAY);
+		glDisableClientState (GL_VERTEX_ARRAY);
 		_cairo_dock_disable_texture ();
+		g_free (pVertices);
+		g_free (pCoords);
 	}
 }
 
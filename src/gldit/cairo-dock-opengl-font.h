@@ -57,6 +57,7 @@ struct _CairoDockGLFont {
 	gint iNbChars;
 	gdouble iCharWidth;
 	gdouble iCharHeight;
+	gpointer pGlyphs;  // characters outside of the loaded range, rendered on demand into a texture (private).
 };
 
 /* Load a font into bitmaps. You can load any characters of font with this function. The drawback is that each character is a bitmap, that is to say you can't zoom them.
@@ -68,6 +69,7 @@ struct _CairoDockGLFont {
 //CairoDockGLFont *cairo_dock_load_bitmap_font (const gchar *cFontDescription, int first, int count);
 
 /** Load a font into textures. You can then render your text like a normal texture (zoom, etc). The drawback is that only a mono font can be used with this function.
+* Characters outside of the given range (accents, cyrillic, CJK, etc) are rendered on demand the first time they are drawn, one per cell and without shaping, and kept in a texture along with the most recently used ones. Only the texts drawn with this font use it (labels, quick-infos and dialogs are drawn from cairo surfaces).
 *@param cFontDescription a description of the font, for instance "Monospace Bold 12"
 *@param first first character to load.
 *@param count number of characters to load.
@@ -94,7 +96,7 @@ void cairo_dock_free_gl_font (CairoDockGLFont *pFont);
 */
 void cairo_dock_get_gl_text_extent (const gchar *cText, CairoDockGLFont *pFont, int *iWidth, int *iHeight);
 
-/** Render a text for a given font. In the case of a bitmap font, the current raster position is used. In the case of a texture font, the current model view is used.
+/** Render a text for a given font. In the case of a bitmap font, the current raster position is used. In the case of a texture font, the current model view is used, and the text is in UTF-8.
 *@param cText the text
 *@param pFont the font.
 */
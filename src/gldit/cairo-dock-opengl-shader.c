@@ -0,0 +1,239 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <GL/gl.h>
+
+#include "cairo-dock-log.h"
+#include "cairo-dock-image-buffer.h"  // cairo_dock_bind_image_buffer_texture
+#include "cairo-dock-opengl-shader.h"
+
+#define CD_ATTRIB_POSITION 0
+#define CD_ATTRIB_TEXCOORD 1
+
+// private
+static GLuint s_iProgram = 0;
+static GLuint s_iQuadVbo = 0;
+static GLint s_iSizeLocation = -1;
+static GLint s_iTexRectLocation = -1;
+static GLint s_iAlphaLocation = -1;
+static gboolean s_bInPass = FALSE;  // the attributes of the quad are set up for the whole pass.
+static gboolean s_bProgramInUse = FALSE;
+
+// GLSL 1.10, so that it runs on the legacy context the containers use; the fixed-function matrices are used, so that the current transformations apply.
+static const gchar *s_cVertexShader =
+"#version 110\n"
+"attribute vec2 aPosition;\n"
+"attribute vec2 aTexCoord;\n"
+"uniform vec2 uSize;\n"  // size of the quad
+"uniform vec4 uTexRect;\n"  // (u, v, du, dv) of the portion of the texture
+"uniform vec3 uAlpha;\n"  // (dx, dy, center): alpha = center + dx*x + dy*y over the unit quad
+"varying vec2 vTexCoord;\n"
+"varying float vAlpha;\n"
+"void main ()\n"
+"{\n"
+"	vec2 tc = uTexRect.xy + aTexCoord * uTexRect.zw;\n"
+"	vTexCoord = (gl_TextureMatrix[0] * vec4 (tc, 0., 1.)).xy;\n"
+"	vAlpha = uAlpha.z + dot (uAlpha.xy, aPosition);\n"
+"	gl_Position = gl_ModelViewProjectionMatrix * vec4 (aPosition * uSize, 0., 1.);\n"
+"}\n";
+
+static const gchar *s_cFragmentShader =
+"#version 110\n"
+"uniform sampler2D uTexture;\n"
+"varying vec2 vTexCoord;\n"
+"varying float vAlpha;\n"
+"void main ()\n"
+"{\n"
+"	vec4 color = texture2D (uTexture, vTexCoord);\n"
+"	gl_FragColor = vec4 (color.rgb, color.a * vAlpha);\n"  // same as GL_MODULATE with a (1,1,1,alpha) color.
+"}\n";
+
+// the unit quad, as (x, y, u, v), in the same order as _cairo_dock_apply_current_texture_at_size.
+static const GLfloat s_pQuad[4*4] = {
+	-.5,  .5, 0., 0.,
+	 .5,  .5, 1., 0.,
+	 .5, -.5, 1., 1.,
+	-.5, -.5, 0., 1.};
+
+
+static GLuint _compile_shader (GLenum iType, const gchar *cSource)
+{
+	GLuint iShader = glCreateShader (iType);
+	glShaderSource (iShader, 1, &cSource, NULL);
+	glCompileShader (iShader);
+	
+	GLint iStatus = 0;
+	glGetShaderiv (iShader, GL_COMPILE_STATUS, &iStatus);
+	if (! iStatus)
+	{
+		gchar cLog[512];
+		glGetShaderInfoLog (iShader, sizeof (cLog), NULL, cLog);
+		cd_warning ("couldn't compile the %s shader: %s", iType == GL_VERTEX_SHADER ? "vertex" : "fragment", cLog);
+		glDeleteShader (iShader);
+		return 0;
+	}
+	return iShader;
+}
+
+gboolean gldi_gl_shaders_load (void)
+{
+	if (s_iProgram != 0)
+		return TRUE;
+	
+	//\_______________ build the program.
+	GLuint iVertexShader = _compile_shader (GL_VERTEX_SHADER, s_cVertexShader);
+	GLuint iFragmentShader = _compile_shader (GL_FRAGMENT_SHADER, s_cFragmentShader);
+	if (iVertexShader == 0 || iFragmentShader == 0)
+	{
+		if (iVertexShader != 0)
+			glDeleteShader (iVertexShader);
+		if (iFragmentShader != 0)
+			glDeleteShader (iFragmentShader);
+		return FALSE;
+	}
+	
+	GLuint iProgram = glCreateProgram ();
+	glAttachShader (iProgram, iVertexShader);
+	glAttachShader (iProgram, iFragmentShader);
+	glBindAttribLocation (iProgram, CD_ATTRIB_POSITION, "aPosition");
+	glBindAttribLocation (iProgram, CD_ATTRIB_TEXCOORD, "aTexCoord");
+	glLinkProgram (iProgram);
+	glDeleteShader (iVertexShader);  // they are only flagged for deletion, and will be freed along with the program.
+	glDeleteShader (iFragmentShader);
+	
+	GLint iStatus = 0;
+	glGetProgramiv (iProgram, GL_LINK_STATUS, &iStatus);
+	if (! iStatus)
+	{
+		gchar cLog[512];
+		glGetProgramInfoLog (iProgram, sizeof (cLog), NULL, cLog);
+		cd_warning ("couldn't link the shaders: %s", cLog);
+		glDeleteProgram (iProgram);
+		return FALSE;
+	}
+	
+	s_iSizeLocation = glGetUniformLocation (iProgram, "uSize");
+	s_iTexRectLocation = glGetUniformLocation (iProgram, "uTexRect");
+	s_iAlphaLocation = glGetUniformLocation (iProgram, "uAlpha");
+	glUseProgram (iProgram);
+	glUniform1i (glGetUniformLocation (iProgram, "uTexture"), 0);  // texture unit 0
+	glUseProgram (0);
+	
+	//\_______________ upload the quad once for all.
+	glGenBuffers (1, &s_iQuadVbo);
+	glBindBuffer (GL_ARRAY_BUFFER, s_iQuadVbo);
+	glBufferData (GL_ARRAY_BUFFER, sizeof (s_pQuad), s_pQuad, GL_STATIC_DRAW);
+	glBindBuffer (GL_ARRAY_BUFFER, 0);
+	
+	s_iProgram = iProgram;
+	cd_message ("GLSL shaders loaded");
+	return TRUE;
+}
+
+void gldi_gl_shaders_unload (void)
+{
+	s_bInPass = FALSE;
+	s_bProgramInUse = FALSE;
+	if (s_iProgram != 0)
+	{
+		glDeleteProgram (s_iProgram);
+		s_iProgram = 0;
+	}
+	if (s_iQuadVbo != 0)
+	{
+		glDeleteBuffers (1, &s_iQuadVbo);
+		s_iQuadVbo = 0;
+	}
+}
+
+gboolean gldi_gl_shaders_are_loaded (void)
+{
+	return (s_iProgram != 0);
+}
+
+
+static void _setup_quad_attributes (void)
+{
+	// the pointers keep a reference on the VBO, so it can be unbound right away; that way the client-side arrays of the fixed pipeline keep working.
+	glBindBuffer (GL_ARRAY_BUFFER, s_iQuadVbo);
+	glVertexAttribPointer (CD_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, 4 * sizeof (GLfloat), (GLvoid*)0);
+	glVertexAttribPointer (CD_ATTRIB_TEXCOORD, 2, GL_FLOAT, GL_FALSE, 4 * sizeof (GLfloat), (GLvoid*)(2 * sizeof (GLfloat)));
+	glBindBuffer (GL_ARRAY_BUFFER, 0);
+}
+
+static inline void _use_program (void)
+{
+	if (s_bProgramInUse)
+		return;
+	glUseProgram (s_iProgram);
+	glEnableVertexAttribArray (CD_ATTRIB_POSITION);
+	glEnableVertexAttribArray (CD_ATTRIB_TEXCOORD);
+	s_bProgramInUse = TRUE;
+}
+
+void gldi_gl_shaders_release (void)
+{
+	if (! s_bProgramInUse)
+		return;
+	glDisableVertexAttribArray (CD_ATTRIB_POSITION);  // the generic attribute 0 would take precedence over the vertex array of the fixed pipeline.
+	glDisableVertexAttribArray (CD_ATTRIB_TEXCOORD);
+	glUseProgram (0);  // let the rest of the drawing use the fixed pipeline.
+	s_bProgramInUse = FALSE;
+}
+
+void gldi_gl_shaders_begin_pass (void)
+{
+	if (s_iProgram == 0)
+		return;
+	_setup_quad_attributes ();
+	s_bInPass = TRUE;
+}
+
+void gldi_gl_shaders_end_pass (void)
+{
+	gldi_gl_shaders_release ();
+	s_bInPass = FALSE;
+}
+
+void gldi_gl_shader_draw_image_full (const CairoDockImageBuffer *pImage, double fWidth, double fHeight, double u, double v, double du, double dv, double fAlpha, double fAlphaDx, double fAlphaDy)
+{
+	g_return_if_fail (s_iProgram != 0);
+	
+	cairo_dock_bind_image_buffer_texture (pImage);
+	const GldiTextureAtlasLocation *pLocation = gldi_texture_atlas_get_image_location (pImage);
+	if (pLocation != NULL)  // map the portion inside the image's location in the atlas.
+	{
+		u = pLocation->u + u * pLocation->du;
+		v = pLocation->v + v * pLocation->dv;
+		du *= pLocation->du;
+		dv *= pLocation->dv;
+	}
+	
+	if (! s_bInPass)
+		_setup_quad_attributes ();
+	_use_program ();  // inside a pass, consecutive draws keep the program.
+	glUniform2f (s_iSizeLocation, fWidth, fHeight);
+	glUniform4f (s_iTexRectLocation, u, v, du, dv);
+	glUniform3f (s_iAlphaLocation, fAlphaDx, fAlphaDy, fAlpha);
+	
+	glDrawArrays (GL_TRIANGLE_FAN, 0, 4);
+	
+	if (! s_bInPass)
+		gldi_gl_shaders_release ();
+}
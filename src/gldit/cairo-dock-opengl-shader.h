@@ -0,0 +1,85 @@
+/*
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __CAIRO_DOCK_OPENGL_SHADER__
+#define  __CAIRO_DOCK_OPENGL_SHADER__
+
+#include <glib.h>
+#include <GL/gl.h>
+
+#include "cairo-dock-struct.h"
+G_BEGIN_DECLS
+
+/**
+*@file cairo-dock-opengl-shader.h This class draws images with a small GLSL program and a persistent vertex buffer, rather than with the fixed-function pipeline and the immediate mode.
+* It is only used if it has been requested (see \ref gldi_gl_backend_use_shaders) and if the driver supports it.
+* The program still follows the current modelview, projection and texture matrices, so it can be mixed with the rest of the OpenGL drawing.
+*/
+
+/** Compile the shaders and create the vertex buffer. The OpenGL context must be current.
+*@return TRUE if the shaders can be used.
+*/
+gboolean gldi_gl_shaders_load (void);
+
+/** Destroy the shaders and the vertex buffer. The OpenGL context must be current.
+*/
+void gldi_gl_shaders_unload (void);
+
+/** Tell if the shaders are loaded, that is to say if the drawing functions of this class can be used.
+*@return TRUE if the shaders are loaded.
+*/
+gboolean gldi_gl_shaders_are_loaded (void);
+
+/** Start a render pass: the vertex buffer is set up once for all the drawings of the pass, and consecutive drawings keep the shader program, only updating their uniforms. Code that uses the fixed pipeline in the middle of a pass must call \ref gldi_gl_shaders_release before. Does nothing if the shaders are not loaded.
+*/
+void gldi_gl_shaders_begin_pass (void);
+
+/** End a render pass started with \ref gldi_gl_shaders_begin_pass.
+*/
+void gldi_gl_shaders_end_pass (void);
+
+/** Give back the fixed pipeline, if a previous drawing of the current pass left the shader program in use. The next drawing will use it again.
+*/
+void gldi_gl_shaders_release (void);
+
+/** Draw a portion of an ImageBuffer centered on the current point, at a given size, with an alpha that varies linearly over the image. The texture is bound by this function, taking into account its location in the atlas.
+*@param pImage an ImageBuffer.
+*@param fWidth width
+*@param fHeight height
+*@param u horizontal texture coordinate of the top-left corner.
+*@param v vertical texture coordinate of the top-left corner.
+*@param du width of the portion (can be negative to flip the image).
+*@param dv height of the portion (can be negative to flip the image).
+*@param fAlpha alpha at the center of the image.
+*@param fAlphaDx variation of the alpha from the left to the right border.
+*@param fAlphaDy variation of the alpha from the top to the bottom border.
+*/
+void gldi_gl_shader_draw_image_full (const CairoDockImageBuffer *pImage, double fWidth, double fHeight, double u, double v, double du, double dv, double fAlpha, double fAlphaDx, double fAlphaDy);
+
+/** Draw an ImageBuffer centered on the current point, at a given size and with a given transparency.
+*@param pImage an ImageBuffer.
+*@param fWidth width
+*@param fHeight height
+*@param fAlpha the transparency, between 0 and 1.
+*/
+#define gldi_gl_shader_draw_image(pImage, fWidth, fHeight, fAlpha) gldi_gl_shader_draw_image_full (pImage, fWidth, fHeight, 0., 0., 1., 1., fAlpha, 0., 0.)
+
+
+G_END_DECLS
+#endif
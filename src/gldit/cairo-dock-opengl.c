@@ -18,6 +18,7 @@
 */
 
 #include <math.h>
+#include <stdlib.h>  // atoi
 #include <GL/gl.h>
 #include <GL/glu.h>  // gluLookAt
 
@@ -26,6 +27,8 @@
 #include "cairo-dock-icon-facility.h"  // cairo_dock_get_icon_extent
 #include "cairo-dock-draw-opengl.h"
 #include "cairo-dock-desktop-manager.h"  // desktop dimensions
+#include "cairo-dock-opengl-shader.h"  // gldi_gl_shaders_load
+#include "cairo-dock-texture-atlas.h"  // gldi_texture_atlas_reset_binding
 
 #include "cairo-dock-opengl.h"
 
@@ -41,6 +44,7 @@ extern gboolean g_bEasterEggs;
 static GldiGLManagerBackend s_backend;
 static gboolean s_bInitialized = FALSE;
 static gboolean s_bForceOpenGL = FALSE;
+static gboolean s_bUseShaders = FALSE;
 
 
 gboolean gldi_gl_backend_init (gboolean bForceOpenGL)
@@ -57,6 +61,7 @@ gboolean gldi_gl_backend_init (gboolean bForceOpenGL)
 
 void gldi_gl_backend_deactivate (void)
 {
+	gldi_gl_shaders_unload ();
 	if (g_bUseOpenGL && s_backend.stop)
 		s_backend.stop ();
 	g_bUseOpenGL = FALSE;
@@ -68,6 +73,11 @@ void gldi_gl_backend_force_indirect_rendering (void)
 		g_openglConfig.bIndirectRendering = TRUE;
 }
 
+void gldi_gl_backend_use_shaders (void)
+{
+	s_bUseShaders = TRUE;
+}
+
 
 static inline void _set_perspective_view (int iWidth, int iHeight)
 {
@@ -151,6 +161,7 @@ void gldi_gl_container_set_ortho_view_for_icon (Icon *pIcon)
 
 gboolean gldi_gl_container_make_current (GldiContainer *pContainer)
 {
+	gldi_texture_atlas_reset_binding ();  // the bound texture belongs to the context.
 	if (s_backend.container_make_current)
 		return s_backend.container_make_current (pContainer);
 	return FALSE;
@@ -308,6 +319,7 @@ static void _post_initialize_opengl_backend (G_GNUC_UNUSED GtkWidget *pWidget, G
 	
 	g_openglConfig.bNonPowerOfTwoAvailable = _check_gl_extension ("GL_ARB_texture_non_power_of_two");
 	g_openglConfig.bAccumBufferAvailable = _check_gl_extension ("GL_SUN_slice_accum");
+	g_openglConfig.bVboAvailable = _check_gl_extension ("GL_ARB_vertex_buffer_object");
 	
 	GLfloat fMaximumAnistropy = 0.;
 	if (_check_gl_extension ("GL_EXT_texture_filter_anisotropic"))
@@ -319,13 +331,16 @@ static void _post_initialize_opengl_backend (G_GNUC_UNUSED GtkWidget *pWidget, G
 	const gchar *cVersion  = (const gchar *) glGetString (GL_VERSION);
 	const gchar *cVendor   = (const gchar *) glGetString (GL_VENDOR);
 	const gchar *cRenderer = (const gchar *) glGetString (GL_RENDERER);
+	g_openglConfig.bShadersAvailable = (cVersion != NULL && atoi (cVersion) >= 2 && g_openglConfig.bVboAvailable);  // GLSL is in the core since OpenGL 2.0
 
-	cd_message ("OpenGL config summary :\n - bNonPowerOfTwoAvailable : %d\n - bFboAvailable : %d\n - direct rendering : %d\n - bTextureFromPixmapAvailable : %d\n - bAccumBufferAvailable : %d\n - Anisotroy filtering level max : %.1f\n - OpenGL version: %s\n - OpenGL vendor: %s\n - OpenGL renderer: %s\n\n",
+	cd_message ("OpenGL config summary :\n - bNonPowerOfTwoAvailable : %d\n - bFboAvailable : %d\n - direct rendering : %d\n - bTextureFromPixmapAvailable : %d\n - bAccumBufferAvailable : %d\n - bVboAvailable : %d\n - bShadersAvailable : %d\n - Anisotroy filtering level max : %.1f\n - OpenGL version: %s\n - OpenGL vendor: %s\n - OpenGL renderer: %s\n\n",
 		g_openglConfig.bNonPowerOfTwoAvailable,
 		g_openglConfig.bFboAvailable,
 		!g_openglConfig.bIndirectRendering,
 		g_openglConfig.bTextureFromPixmapAvailable,
 		g_openglConfig.bAccumBufferAvailable,
+		g_openglConfig.bVboAvailable,
+		g_openglConfig.bShadersAvailable,
 		fMaximumAnistropy,
 		cVersion,
 		cVendor,
@@ -341,6 +356,14 @@ static void _post_initialize_opengl_backend (G_GNUC_UNUSED GtkWidget *pWidget, G
 			cVersion, cVendor, cRenderer);
 		gldi_gl_backend_deactivate ();
 	}
+	
+	if (g_bUseOpenGL && s_bUseShaders)
+	{
+		if (! g_openglConfig.bShadersAvailable)
+			cd_warning ("GLSL shaders are not supported by this driver, the fixed pipeline will be used.");
+		else if (! gldi_gl_shaders_load ())
+			cd_warning ("couldn't load the GLSL shaders, the fixed pipeline will be used.");
+	}
 }
 
 void gldi_gl_container_init (GldiContainer *pContainer)
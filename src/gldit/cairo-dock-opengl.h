@@ -48,6 +48,8 @@ struct _CairoDockGLConfig {
 	void (*bindTexImage) (EGLDisplay *display, EGLSurface drawable, int buffer);  // texture from pixmap
 	void (*releaseTexImage) (EGLDisplay *display, EGLSurface drawable, int buffer);  // texture from pixmap
 	#endif
+	gboolean bVboAvailable;  // new fields go at the end, the structure is exported through g_openglConfig.
+	gboolean bShadersAvailable;
 };
 
 struct _GldiGLManagerBackend {
@@ -78,6 +80,10 @@ void gldi_gl_backend_deactivate (void);
 */
 void gldi_gl_backend_force_indirect_rendering (void);
 
+/** Draw the icons with GLSL shaders and vertex buffers rather than with the fixed-function pipeline, if the driver supports it. Must be called before the first container is created.
+*/
+void gldi_gl_backend_use_shaders (void);
+
 
   ///////////////
  // CONTAINER //
@@ -27,6 +27,7 @@
 #include "cairo-dock-draw.h"
 #include "cairo-dock-draw-opengl.h"
 #include "cairo-dock-image-buffer.h"
+#include "cairo-dock-text-cache.h"
 #include "cairo-dock-log.h"
 #define _MANAGER_DEF_
 #include "cairo-dock-overlay.h"
@@ -118,6 +119,20 @@ CairoOverlay *cairo_dock_add_overlay_from_texture (Icon *pIcon, GLuint iTexture,
 	return gldi_overlay_new (&attr);
 }
 
+CairoOverlay *cairo_dock_add_overlay_from_text (Icon *pIcon, const gchar *cText, GldiTextDescription *pTextDescription, double fMaxScale, int iMaxWidth, CairoOverlayPosition iPosition, gpointer data)
+{
+	CairoOverlayAttr attr;
+	memset (&attr, 0, sizeof (CairoOverlayAttr));
+	attr.iPosition = iPosition;
+	attr.pIcon = pIcon;
+	attr.data = data;
+	attr.cText = cText;
+	attr.pTextDescription = pTextDescription;
+	attr.fTextMaxScale = fMaxScale;
+	attr.iTextMaxWidth = iMaxWidth;
+	return gldi_overlay_new (&attr);
+}
+
 
 void cairo_dock_remove_overlay_at_position (Icon *pIcon, CairoOverlayPosition iPosition, gpointer data)
 {
@@ -428,6 +443,10 @@ static void init_object (GldiObject *obj, gpointer attr)
 	{
 		cairo_dock_load_image_buffer_from_texture (&pOverlay->image, cattr->iTexture, 1, 1);  // size will be used to draw it if the scale is set to 0.
 	}
+	else if (cattr->cText != NULL && cattr->pTextDescription != NULL)
+	{
+		gldi_text_cache_load_image_buffer (&pOverlay->image, cattr->cText, cattr->pTextDescription, cattr->fTextMaxScale, cattr->iTextMaxWidth);
+	}
 	
 	if (cattr->data != NULL)
 	{
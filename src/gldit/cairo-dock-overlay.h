@@ -69,6 +69,10 @@ struct _CairoOverlayAttr {
 	cairo_surface_t *pSurface;
 	int iWidth, iHeight;
 	GLuint iTexture;
+	const gchar *cText;
+	GldiTextDescription *pTextDescription;
+	double fTextMaxScale;
+	int iTextMaxWidth;
 };
 
 // signals
@@ -127,6 +131,18 @@ CairoOverlay *cairo_dock_add_overlay_from_surface (Icon *pIcon, cairo_surface_t
  */
 CairoOverlay *cairo_dock_add_overlay_from_texture (Icon *pIcon, GLuint iTexture, CairoOverlayPosition iPosition, gpointer data);
 
+/** Add an overlay on an icon from a text. The image of the text is taken from the text cache, so displaying the same text again is cheap.
+ *@param pIcon the icon
+ *@param cText the text
+ *@param pTextDescription description of the text
+ *@param fMaxScale maximum scale the text will be drawn at
+ *@param iMaxWidth maximum width of the text, 0 for no limit
+ *@param iPosition position where to display the overlay
+ *@param data data that will be used to look for the overlay in \ref cairo_dock_remove_overlay_at_position; if NULL, then this function can't be used
+ *@return the overlay.
+ */
+CairoOverlay *cairo_dock_add_overlay_from_text (Icon *pIcon, const gchar *cText, GldiTextDescription *pTextDescription, double fMaxScale, int iMaxWidth, CairoOverlayPosition iPosition, gpointer data);
+
 
 /** Set the scale of an overlay; by default it's 0.5
  *@param pOverlay the overlay
@@ -23,8 +23,12 @@
 #include <cairo.h>
 
 #include "cairo-dock-draw-opengl.h"
+#include "cairo-dock-opengl.h"  // g_openglConfig
 #include "cairo-dock-particle-system.h"
 
+// dependancies
+extern CairoDockGLConfig g_openglConfig;
+
 static GLfloat s_pCornerCoords[8] = {0.0, 0.0,
 	0.0, 1.0,
 	1.0, 1.0,
@@ -149,11 +153,55 @@ void cairo_dock_render_particles_full (CairoParticleSystem *pParticleSystem, int
 	glEnableClientState (GL_TEXTURE_COORD_ARRAY);
 	glEnableClientState (GL_VERTEX_ARRAY);
 	
-	glTexCoordPointer(2, GL_FLOAT, 2 * sizeof(GLfloat), pParticleSystem->pCoords);
-	glVertexPointer(3, GL_FLOAT, 3 * sizeof(GLfloat), pParticleSystem->pVertices);
-	glColorPointer(4, GL_FLOAT, 4 * sizeof(GLfloat), pParticleSystem->pColors);
-
-	glDrawArrays(GL_QUADS, 0, pParticleSystem->bAddLight ? numActive*2 : numActive);
+	if (g_openglConfig.bVboAvailable)
+	{
+		// the texture coordinates never change, upload them once.
+		if (pParticleSystem->iCoordsVbo == 0)
+		{
+			glGenBuffers (1, &pParticleSystem->iCoordsVbo);
+			glBindBuffer (GL_ARRAY_BUFFER, pParticleSystem->iCoordsVbo);
+			glBufferData (GL_ARRAY_BUFFER, pParticleSystem->iNbParticles * 4 * 2 * sizeof(GLfloat)*2, pParticleSystem->pCoords, GL_STATIC_DRAW);
+			glGenBuffers (1, &pParticleSystem->iVbo);
+		}
+		glBindBuffer (GL_ARRAY_BUFFER, pParticleSystem->iCoordsVbo);
+		glTexCoordPointer(2, GL_FLOAT, 2 * sizeof(GLfloat), (GLvoid*)0);
+		
+		// stream the vertices and colors of the active particles only, the light ones being right after the normal ones.
+		int iNbVertices = (pParticleSystem->bAddLight ? numActive*2 : numActive);
+		GLsizeiptr iVerticesSize = numActive * 3 * sizeof(GLfloat);
+		GLsizeiptr iColorsSize = numActive * 4 * sizeof(GLfloat);
+		GLintptr iColorsOffset = iNbVertices * 3 * sizeof(GLfloat);
+		glBindBuffer (GL_ARRAY_BUFFER, pParticleSystem->iVbo);
+		glBufferData (GL_ARRAY_BUFFER, iNbVertices * (3 + 4) * sizeof(GLfloat), NULL, GL_STREAM_DRAW);  // orphan the previous buffer, so that we don't wait for the GPU to be done with it.
+		glBufferSubData (GL_ARRAY_BUFFER, 0, iVerticesSize, pParticleSystem->pVertices);
+		glBufferSubData (GL_ARRAY_BUFFER, iColorsOffset, iColorsSize, pParticleSystem->pColors);
+		if (pParticleSystem->bAddLight)
+		{
+			glBufferSubData (GL_ARRAY_BUFFER, iVerticesSize, iVerticesSize, &pParticleSystem->pVertices[pParticleSystem->iNbParticles * 4 * 3]);
+			glBufferSubData (GL_ARRAY_BUFFER, iColorsOffset + iColorsSize, iColorsSize, &pParticleSystem->pColors[pParticleSystem->iNbParticles * 4 * 4]);
+		}
+		glVertexPointer(3, GL_FLOAT, 3 * sizeof(GLfloat), (GLvoid*)0);
+		glColorPointer(4, GL_FLOAT, 4 * sizeof(GLfloat), (GLvoid*)iColorsOffset);
+		
+		glDrawArrays(GL_QUADS, 0, iNbVertices);
+		
+		glBindBuffer (GL_ARRAY_BUFFER, 0);
+	}
+	else
+	{
+		// draw the active particles only, they are packed at the beginning of each array; the light ones are in the second half of the arrays.
+		glTexCoordPointer(2, GL_FLOAT, 2 * sizeof(GLfloat), pParticleSystem->pCoords);
+		glVertexPointer(3, GL_FLOAT, 3 * sizeof(GLfloat), pParticleSystem->pVertices);
+		glColorPointer(4, GL_FLOAT, 4 * sizeof(GLfloat), pParticleSystem->pColors);
+		glDrawArrays(GL_QUADS, 0, numActive);
+		
+		if (pParticleSystem->bAddLight)
+		{
+			glVertexPointer(3, GL_FLOAT, 3 * sizeof(GLfloat), &pParticleSystem->pVertices[pParticleSystem->iNbParticles * 4 * 3]);
+			glColorPointer(4, GL_FLOAT, 4 * sizeof(GLfloat), &pParticleSystem->pColors[pParticleSystem->iNbParticles * 4 * 4]);
+			glDrawArrays(GL_QUADS, 0, numActive);  // the texture coordinates are the same for all the quads.
+		}
+	}
 
 	glDisableClientState(GL_COLOR_ARRAY);
 	glDisableClientState (GL_TEXTURE_COORD_ARRAY);
@@ -200,6 +248,12 @@ void cairo_dock_free_particle_system (CairoParticleSystem *pParticleSystem)
 	
 	g_free (pParticleSystem->pParticles);
 	
+	if (pParticleSystem->iCoordsVbo != 0)
+	{
+		glDeleteBuffers (1, &pParticleSystem->iCoordsVbo);
+		glDeleteBuffers (1, &pParticleSystem->iVbo);
+	}
+	
 	free (pParticleSystem->pVertices);
 	free (pParticleSystem->pCoords);
 	free (pParticleSystem->pColors);
@@ -208,6 +262,13 @@ void cairo_dock_free_particle_system (CairoParticleSystem *pParticleSystem)
 }
 
 
+// sine approximation (error < 0.1%), which is plenty for the oscillations of the particles, and much cheaper than sin() on thousands of particles. x must be in [-pi, pi].
+static inline GLfloat _fast_sin (GLfloat x)
+{
+	GLfloat y = (4 / G_PI) * x - (4 / (G_PI * G_PI)) * x * fabsf (x);
+	return .225f * (y * fabsf (y) - y) + y;
+}
+
 gboolean cairo_dock_update_default_particle_system (CairoParticleSystem *pParticleSystem, CairoDockRewindParticleFunc pRewindParticle)
 {
 	gboolean bAllParticlesEnded = TRUE;
@@ -218,7 +279,9 @@ gboolean cairo_dock_update_default_particle_system (CairoParticleSystem *pPartic
 		p = &(pParticleSystem->pParticles[i]);
 		
 		p->fOscillation += p->fOmega;
-		p->x += p->vx + (p->z + 2)/3. * .02 * sin (p->fOscillation);  // 3%
+		if (p->fOscillation > G_PI || p->fOscillation < -G_PI)  // keep the phase in [-pi, pi], it also preserves its precision.
+			p->fOscillation = remainderf (p->fOscillation, 2 * G_PI);
+		p->x += p->vx + (p->z + 2) * (.02f / 3) * _fast_sin (p->fOscillation);  // 3%
 		p->y += p->vy;
 		p->color[3] = 1.*p->iLife / p->iInitialLife;
 		p->fSizeFactor += p->fResizeSpeed;
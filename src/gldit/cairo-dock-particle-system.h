@@ -74,6 +74,8 @@ typedef struct _CairoParticleSystem {
 	gboolean bDirectionUp;
 	gboolean bAddLuminance;
 	gboolean bAddLight;
+	GLuint iVbo;  // buffer where the vertices and colors are streamed at each frame, if VBOs are available.
+	GLuint iCoordsVbo;  // buffer of the texture coordinates, that never change.
 	} CairoParticleSystem;
 
 /// Function that re-initializes a particle when its life is over.
@@ -0,0 +1,207 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define _GNU_SOURCE  // dladdr
+#include <string.h>
+#include <dlfcn.h>
+
+#include "cairo-dock-log.h"
+#include "cairo-dock-object.h"  // gldi_object_get_type
+#include "cairo-dock-profiler.h"
+
+// public (manager, config, data)
+gboolean g_bGldiProfiling = FALSE;
+
+// private
+typedef struct {
+	const gchar *cObjectType;  // name of the ObjectManager, a static string.
+	guint iNotifType;
+	gpointer pFunction;
+	} GldiProfilerNotificationKey;
+
+typedef struct {
+	gchar *cName;  // for the report
+	guint iNbCalls;
+	gint64 iTotalTime;  // in us
+	gint64 iMaxTime;  // in us
+	} GldiProfilerStat;
+
+static GHashTable *s_hNotificationStats = NULL;  // key -> stat
+static GHashTable *s_hFrameStats = NULL;  // container -> stat
+
+
+static guint _notification_key_hash (const GldiProfilerNotificationKey *pKey)
+{
+	return g_direct_hash (pKey->pFunction) ^ g_str_hash (pKey->cObjectType) ^ (pKey->iNotifType << 24);
+}
+
+static gboolean _notification_key_equal (const GldiProfilerNotificationKey *pKey1, const GldiProfilerNotificationKey *pKey2)
+{
+	return (pKey1->pFunction == pKey2->pFunction
+		&& pKey1->iNotifType == pKey2->iNotifType
+		&& strcmp (pKey1->cObjectType, pKey2->cObjectType) == 0);
+}
+
+static void _free_stat (GldiProfilerStat *pStat)
+{
+	g_free (pStat->cName);
+	g_free (pStat);
+}
+
+static void _create_tables (void)
+{
+	s_hNotificationStats = g_hash_table_new_full ((GHashFunc) _notification_key_hash,
+		(GEqualFunc) _notification_key_equal,
+		g_free,
+		(GDestroyNotify) _free_stat);
+	s_hFrameStats = g_hash_table_new_full (g_direct_hash,
+		g_direct_equal,
+		NULL,
+		(GDestroyNotify) _free_stat);
+}
+
+static inline void _add_time (GldiProfilerStat *pStat, gint64 iDuration)
+{
+	pStat->iNbCalls ++;
+	pStat->iTotalTime += iDuration;
+	if (iDuration > pStat->iMaxTime)
+		pStat->iMaxTime = iDuration;
+}
+
+static gchar *_get_function_name (gpointer pFunction)
+{
+	// the name of the library tells which applet the callback belongs to; the symbol is only known for non-static functions.
+	Dl_info info;
+	if (dladdr (pFunction, &info) != 0 && info.dli_fname != NULL)
+	{
+		const gchar *cLibName = strrchr (info.dli_fname, '/');
+		return g_strdup_printf ("%s (%s)",
+			info.dli_sname && info.dli_saddr == pFunction ? info.dli_sname : "?",
+			cLibName ? cLibName + 1 : info.dli_fname);
+	}
+	return g_strdup_printf ("%p", pFunction);
+}
+
+
+void gldi_profiler_enable (gboolean bEnable)
+{
+	if (bEnable && s_hNotificationStats == NULL)
+		_create_tables ();
+	g_bGldiProfiling = bEnable;
+}
+
+void gldi_profiler_reset (void)
+{
+	if (s_hNotificationStats != NULL)
+	{
+		g_hash_table_remove_all (s_hNotificationStats);
+		g_hash_table_remove_all (s_hFrameStats);
+	}
+}
+
+void gldi_profiler_record_notification (const gchar *cObjectType, guint iNotifType, gpointer pFunction, gint64 iDuration)
+{
+	g_return_if_fail (s_hNotificationStats != NULL);
+	GldiProfilerNotificationKey key = {cObjectType, iNotifType, pFunction};
+	GldiProfilerStat *pStat = g_hash_table_lookup (s_hNotificationStats, &key);
+	if (pStat == NULL)
+	{
+		pStat = g_new0 (GldiProfilerStat, 1);
+		gchar *cFunctionName = _get_function_name (pFunction);
+		pStat->cName = g_strdup_printf ("%s #%u: %s", cObjectType, iNotifType, cFunctionName);
+		g_free (cFunctionName);
+		g_hash_table_insert (s_hNotificationStats, g_memdup (&key, sizeof (key)), pStat);
+	}
+	_add_time (pStat, iDuration);
+}
+
+void gldi_profiler_record_frame (GldiContainer *pContainer, gint64 iDuration)
+{
+	g_return_if_fail (s_hFrameStats != NULL);
+	GldiProfilerStat *pStat = g_hash_table_lookup (s_hFrameStats, pContainer);
+	if (pStat == NULL)
+	{
+		pStat = g_new0 (GldiProfilerStat, 1);
+		pStat->cName = g_strdup_printf ("%s %p", gldi_object_get_type (pContainer), pContainer);
+		g_hash_table_insert (s_hFrameStats, pContainer, pStat);
+	}
+	_add_time (pStat, iDuration);
+}
+
+void gldi_profiler_forget_container (GldiContainer *pContainer)
+{
+	if (s_hFrameStats != NULL)
+		g_hash_table_remove (s_hFrameStats, pContainer);  // its address can be reused by a new container.
+}
+
+
+static gint _compare_total_time (const GldiProfilerStat *pStat1, const GldiProfilerStat *pStat2)
+{
+	return (pStat1->iTotalTime < pStat2->iTotalTime ? 1 : pStat1->iTotalTime > pStat2->iTotalTime ? -1 : 0);
+}
+
+static void _append_stats (GString *sReport, GHashTable *pTable, const gchar *cTitle, const gchar *cCountName)
+{
+	g_string_append_printf (sReport, "%s:\n%10s %12s %10s %10s  %s\n", cTitle, cCountName, "total (ms)", "avg (us)", "max (us)", "name");
+	GList *pStats = g_list_sort (g_hash_table_get_values (pTable), (GCompareFunc) _compare_total_time);
+	GldiProfilerStat *pStat;
+	GList *s;
+	for (s = pStats; s != NULL; s = s->next)
+	{
+		pStat = s->data;
+		g_string_append_printf (sReport, "%10u %12.2f %10d %10d  %s\n",
+			pStat->iNbCalls,
+			pStat->iTotalTime / 1000.,
+			(int) (pStat->iTotalTime / pStat->iNbCalls),
+			(int) pStat->iMaxTime,
+			pStat->cName);
+	}
+	g_list_free (pStats);
+	g_string_append_c (sReport, '\n');
+}
+
+gchar *gldi_profiler_get_report (void)
+{
+	GString *sReport = g_string_new ("");
+	if (s_hNotificationStats == NULL)
+	{
+		g_string_append (sReport, "The profiler has never been enabled.\n");
+		return g_string_free (sReport, FALSE);
+	}
+	
+	_append_stats (sReport, s_hFrameStats, "Frames", "frames");
+	_append_stats (sReport, s_hNotificationStats, "Notifications", "calls");
+	return g_string_free (sReport, FALSE);
+}
+
+gboolean gldi_profiler_dump_to_file (const gchar *cFilePath)
+{
+	g_return_val_if_fail (cFilePath != NULL, FALSE);
+	gchar *cReport = gldi_profiler_get_report ();
+	GError *erreur = NULL;
+	g_file_set_contents (cFilePath, cReport, -1, &erreur);
+	g_free (cReport);
+	if (erreur != NULL)
+	{
+		cd_warning ("couldn't write the profiling data: %s", erreur->message);
+		g_error_free (erreur);
+		return FALSE;
+	}
+	return TRUE;
+}
@@ -0,0 +1,72 @@
+/*
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __CAIRO_DOCK_PROFILER__
+#define  __CAIRO_DOCK_PROFILER__
+
+#include <glib.h>
+#include "cairo-dock-struct.h"
+G_BEGIN_DECLS
+
+/**
+*@file cairo-dock-profiler.h This class measures the time spent on the hot paths of the dock: the notification callbacks and the drawing of the containers.
+* It is disabled by default, and costs nothing in this case. Enable it with \ref gldi_profiler_enable (or with the '-P' option of the dock), then get the results with \ref gldi_profiler_get_report or \ref gldi_profiler_dump_to_file.
+*
+* For each notification callback, it records the number of calls, and the total and maximum time spent in it; callbacks are identified by the type of the object they are registered on, the notification, and the library (core or applet) that provides them.
+* For each container, it records the number of frames drawn, and the total and maximum time of a frame.
+*/
+
+extern gboolean g_bGldiProfiling;
+
+/** Say if the profiler is currently recording.
+*/
+#define gldi_profiler_is_enabled() G_UNLIKELY (g_bGldiProfiling)
+
+/** Start or stop recording. The data already recorded are kept.
+*@param bEnable TRUE to record, FALSE to stop.
+*/
+void gldi_profiler_enable (gboolean bEnable);
+
+/** Forget all the data recorded until now.
+*/
+void gldi_profiler_reset (void);
+
+// internal, called by gldi_object_notify.
+void gldi_profiler_record_notification (const gchar *cObjectType, guint iNotifType, gpointer pFunction, gint64 iDuration);
+
+// internal, called when a container has been drawn.
+void gldi_profiler_record_frame (GldiContainer *pContainer, gint64 iDuration);
+
+// internal, called when a container is destroyed.
+void gldi_profiler_forget_container (GldiContainer *pContainer);
+
+/** Get a human-readable report of the recorded data, sorted by total time.
+*@return a newly allocated string.
+*/
+gchar *gldi_profiler_get_report (void);
+
+/** Write the report into a file.
+*@param cFilePath path of the file.
+*@return TRUE on success.
+*/
+gboolean gldi_profiler_dump_to_file (const gchar *cFilePath);
+
+G_END_DECLS
+#endif
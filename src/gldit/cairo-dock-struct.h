@@ -394,6 +394,7 @@ typedef struct _IconInterface IconInterface;
 typedef struct _Icon Icon;
 typedef struct _GldiContainer GldiContainer;
 typedef struct _GldiContainerInterface GldiContainerInterface;
+typedef struct _GldiContainerPrivate GldiContainerPrivate;
 typedef struct _CairoDock CairoDock;
 typedef struct _CairoDesklet CairoDesklet;
 typedef struct _CairoDialog CairoDialog;
@@ -440,6 +441,8 @@ typedef struct _CairoDockGLPath CairoDockGLPath;
 
 typedef struct _CairoDockImageBuffer CairoDockImageBuffer;
 
+typedef struct _GldiTextureAtlas GldiTextureAtlas;
+
 typedef struct _CairoOverlay CairoOverlay;
 
 typedef struct _GldiTask GldiTask;
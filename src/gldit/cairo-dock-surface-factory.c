@@ -261,55 +261,33 @@ static inline void _apply_orientation_and_scale (cairo_t *pCairoContext, CairoDo
 }
 
 
-cairo_surface_t *cairo_dock_create_surface_from_xicon_buffer (gulong *pXIconBuffer, int iBufferNbElements, int iWidth, int iHeight)
+static inline guint _premultiply (guint c, guint a)
+{
+	guint t = c * a + 128;  // c * a / 255, rounded, without division.
+	return (t + (t >> 8)) >> 8;
+}
+static cairo_surface_t *_create_surface_from_xicon_pixels (gulong *pXIconPixels, int w, int h, int iWidth, int iHeight, gboolean bImageSurface)
 {
-	//\____________________ On recupere la plus grosse des icones presentes dans le tampon (meilleur rendu).
-	int iIndex = 0, iBestIndex = 0;
-	while (iIndex + 2 < iBufferNbElements)
-	{
-		if (pXIconBuffer[iIndex] == 0 || pXIconBuffer[iIndex+1] == 0)  // precaution au cas ou un buffer foirreux nous serait retourne, on risque de boucler sans fin.
-		{
-			cd_warning ("This icon is broken !\nThis means that one of the current applications has sent a buggy icon to X.");
-			if (iIndex == 0)  // tout le buffer est a jeter.
-				return NULL;
-			break;
-		}
-		if (pXIconBuffer[iIndex] > pXIconBuffer[iBestIndex])
-			iBestIndex = iIndex;
-		iIndex += 2 + pXIconBuffer[iIndex] * pXIconBuffer[iIndex+1];
-	}
-
 	//\____________________ On pre-multiplie chaque composante par le alpha (necessaire pour libcairo).
-	int w = pXIconBuffer[iBestIndex];
-	int h = pXIconBuffer[iBestIndex+1];
-	iBestIndex += 2;
-	//g_print ("%s (%dx%d)\n", __func__, w, h);
-	
 	int i, n = w * h;
-	if (iBestIndex + n > iBufferNbElements)  // precaution au cas ou le nombre d'elements dans le buffer serait incorrect.
-	{
-		cd_warning ("This icon is broken !\nThis means that one of the current applications has sent a buggy icon to X.");
-		return NULL;
-	}
-	gint pixel, alpha, red, green, blue;
-	float fAlphaFactor;
-	gint *pPixelBuffer = (gint *) &pXIconBuffer[iBestIndex];  // on va ecrire le resultat du filtre directement dans le tableau fourni en entree. C'est ok car sizeof(gulong) >= sizeof(gint), donc le tableau de pixels est plus petit que le buffer fourni en entree. merci a Hannemann pour ses tests et ses screenshots ! :-)
+	guint pixel, alpha;
+	guint32 *pPixelBuffer = (guint32 *) pXIconPixels;  // on va ecrire le resultat du filtre directement dans le tableau fourni en entree. C'est ok car sizeof(gulong) >= sizeof(guint32), donc le tableau de pixels est plus petit que le buffer fourni en entree. merci a Hannemann pour ses tests et ses screenshots ! :-)
 	for (i = 0; i < n; i ++)
 	{
-		pixel = (gint) pXIconBuffer[iBestIndex+i];
-		alpha = (pixel & 0xFF000000) >> 24;
-		red   = (pixel & 0x00FF0000) >> 16;
-		green = (pixel & 0x0000FF00) >> 8;
-		blue  = (pixel & 0x000000FF);
-		fAlphaFactor = (float) alpha / 255;
-		red *= fAlphaFactor;
-		green *= fAlphaFactor;
-		blue *= fAlphaFactor;
-		pPixelBuffer[i] = (pixel & 0xFF000000) + (red << 16) + (green << 8) + blue;
+		pixel = (guint) pXIconPixels[i];
+		alpha = pixel >> 24;
+		if (alpha == 0)
+			pixel = 0;
+		else if (alpha != 255)
+			pixel = (alpha << 24)
+				| (_premultiply ((pixel >> 16) & 0xFF, alpha) << 16)
+				| (_premultiply ((pixel >> 8) & 0xFF, alpha) << 8)
+				| _premultiply (pixel & 0xFF, alpha);
+		pPixelBuffer[i] = pixel;
 	}
 
 	//\____________________ On cree la surface a partir du tampon.
-	int iStride = w * sizeof (gint);  // nbre d'octets entre le debut de 2 lignes.
+	int iStride = w * sizeof (guint32);  // nbre d'octets entre le debut de 2 lignes.
 	cairo_surface_t *surface_ini = cairo_image_surface_create_for_data ((guchar *)pPixelBuffer,
 		CAIRO_FORMAT_ARGB32,
 		w,
@@ -326,9 +304,9 @@ cairo_surface_t *cairo_dock_create_surface_from_xicon_buffer (gulong *pXIconBuff
 		&fIconWidthSaturationFactor,
 		&fIconHeightSaturationFactor);
 	
-	cairo_surface_t *pNewSurface = cairo_dock_create_blank_surface (
-		iWidth,
-		iHeight);
+	cairo_surface_t *pNewSurface = (bImageSurface ?
+		cairo_image_surface_create (CAIRO_FORMAT_ARGB32, iWidth, iHeight) :  // doesn't depend on the drawing context, so it can be done outside of the main thread.
+		cairo_dock_create_blank_surface (iWidth, iHeight));
 	cairo_t *pCairoContext = cairo_create (pNewSurface);
 	
 	double fUsefulWidth = w * fIconWidthSaturationFactor;  // a part dans le cas fill && keep ratio, c'est la meme chose que fImageWidth et fImageHeight.
@@ -347,6 +325,43 @@ cairo_surface_t *cairo_dock_create_surface_from_xicon_buffer (gulong *pXIconBuff
 	return pNewSurface;
 }
 
+cairo_surface_t *cairo_dock_create_surface_from_xicon_buffer (gulong *pXIconBuffer, int iBufferNbElements, int iWidth, int iHeight)
+{
+	//\____________________ On recupere la plus grosse des icones presentes dans le tampon (meilleur rendu).
+	int iIndex = 0, iBestIndex = 0;
+	while (iIndex + 2 < iBufferNbElements)
+	{
+		if (pXIconBuffer[iIndex] == 0 || pXIconBuffer[iIndex+1] == 0)  // precaution au cas ou un buffer foirreux nous serait retourne, on risque de boucler sans fin.
+		{
+			cd_warning ("This icon is broken !\nThis means that one of the current applications has sent a buggy icon to X.");
+			if (iIndex == 0)  // tout le buffer est a jeter.
+				return NULL;
+			break;
+		}
+		if (pXIconBuffer[iIndex] > pXIconBuffer[iBestIndex])
+			iBestIndex = iIndex;
+		iIndex += 2 + pXIconBuffer[iIndex] * pXIconBuffer[iIndex+1];
+	}
+
+	int w = pXIconBuffer[iBestIndex];
+	int h = pXIconBuffer[iBestIndex+1];
+	iBestIndex += 2;
+	//g_print ("%s (%dx%d)\n", __func__, w, h);
+	
+	if (iBestIndex + w * h > iBufferNbElements)  // precaution au cas ou le nombre d'elements dans le buffer serait incorrect.
+	{
+		cd_warning ("This icon is broken !\nThis means that one of the current applications has sent a buggy icon to X.");
+		return NULL;
+	}
+	return _create_surface_from_xicon_pixels (&pXIconBuffer[iBestIndex], w, h, iWidth, iHeight, FALSE);
+}
+
+cairo_surface_t *cairo_dock_create_surface_from_xicon_pixels (gulong *pXIconPixels, int w, int h, int iWidth, int iHeight, gboolean bImageSurface)
+{
+	g_return_val_if_fail (pXIconPixels != NULL && w > 0 && h > 0, NULL);
+	return _create_surface_from_xicon_pixels (pXIconPixels, w, h, iWidth, iHeight, bImageSurface);
+}
+
 
 cairo_surface_t *cairo_dock_create_surface_from_pixbuf (GdkPixbuf *pixbuf, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY)
 {
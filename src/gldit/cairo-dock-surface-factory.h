@@ -79,6 +79,17 @@ typedef enum {
 */
 cairo_surface_t *cairo_dock_create_surface_from_xicon_buffer (gulong *pXIconBuffer, int iBufferNbElements, int iWidth, int iHeight);
 
+/** Create a surface from the pixels of one of the icons of an X icon buffer (without the width and height that precede them in the buffer). The buffer is modified.
+*@param pXIconPixels the w x h pixels of the icon, as ARGB longs.
+*@param w width of the icon.
+*@param h height of the icon.
+*@param iWidth width of the surface.
+*@param iHeight height of the surface.
+*@param bImageSurface TRUE to create a mere image surface, that can be done from a thread.
+*@return the newly allocated surface.
+*/
+cairo_surface_t *cairo_dock_create_surface_from_xicon_pixels (gulong *pXIconPixels, int w, int h, int iWidth, int iHeight, gboolean bImageSurface);
+
 /** Create a surface from a GdkPixbuf.
 *@param pixbuf the pixbuf.
 *@param fMaxScale maximum zoom of the icon.
@@ -21,30 +21,42 @@
 #include <stdlib.h>
 
 #include "cairo-dock-log.h"
+#include "cairo-dock-config.h"
+#define _MANAGER_DEF_
 #include "cairo-dock-task.h"
 
+// public (manager, config, data)
+GldiTasksParam myTasksParam;
+GldiManager myTasksMgr;
+
+// dependancies
+
+// private
+static GThreadPool *s_pTaskPool = NULL;  // threads shared by all the tasks to execute their 'get_data' callback.
+static GQueue *s_pCompletedTasks = NULL;  // tasks whose 'get_data' is over and that wait for their 'update'.
+static GMutex *s_pCompletedTasksMutex = NULL;  // protects the queue above, which is filled by the workers.
+static GSource *s_pCompletionSource = NULL;  // source of the main loop that performs the updates.
+static GList *s_pScheduledTasks = NULL;  // periodic tasks waiting for their next iteration, sorted by date.
+static guint s_iSidScheduleTimer = 0;  // the only timer shared by all the periodic tasks, set on the first date of the list above.
+static gint64 s_iScheduleTimerDate = 0;  // date the timer is currently set on.
+
 #ifndef GLIB_VERSION_2_32
 #define G_MUTEX_INIT(a)  a = g_mutex_new ()
-#define G_COND_INIT(a)   a = g_cond_new ()
 #define G_MUTEX_CLEAR(a) g_mutex_free (a)
-#define G_COND_CLEAR(a)  g_cond_free (a)
-#define G_THREAD_UNREF(t) g_free (t)
 #else
 #define G_MUTEX_INIT(a)  a = g_new (GMutex, 1); g_mutex_init (a)
-#define G_COND_INIT(a)   a = g_new (GCond, 1);  g_cond_init (a)
 #define G_MUTEX_CLEAR(a) g_mutex_clear (a); g_free (a)
-#define G_COND_CLEAR(a)  g_cond_clear (a);  g_free (a)
-#define G_THREAD_UNREF(t) if (t) g_thread_unref (t)
 #endif
 
 #define _schedule_next_iteration(pTask) do {\
-	if (pTask->iSidTimer == 0 && pTask->iPeriod)\
-		pTask->iSidTimer = g_timeout_add_seconds (pTask->iPeriod, (GSourceFunc) _launch_task_timer, pTask); } while (0)
+	if (pTask->iSidTimer == 0 && pTask->iNextIteration == 0 && pTask->iPeriod)\
+		_schedule_task (pTask, pTask->iPeriod); } while (0)
 
 #define _cancel_next_iteration(pTask) do {\
 	if (pTask->iSidTimer != 0) {\
 		g_source_remove (pTask->iSidTimer);\
-		pTask->iSidTimer = 0; } } while (0)
+		pTask->iSidTimer = 0; }\
+	_unschedule_task (pTask); } while (0)
 
 #define _set_elapsed_time(pTask) do {\
 	pTask->fElapsedTime = g_timer_elapsed (pTask->pClock, NULL);\
@@ -55,105 +67,235 @@
 		pTask->free_data (pTask->pSharedMemory);\
 	g_timer_destroy (pTask->pClock);\
 	G_MUTEX_CLEAR (pTask->pMutex);\
-	if (pTask->pCond) {\
-		G_COND_CLEAR (pTask->pCond); }\
-	G_THREAD_UNREF (pTask->pThread);\
 	g_free (pTask); } while (0)
 
-static gboolean _launch_task_timer (GldiTask *pTask)
+// free the task, or only its data if some outdated launches are still in the pool (the last of them will free it).
+#define _free_task_when_possible(pTask) do {\
+	if (pTask->iNbLaunches == 0)\
+		_free_task (pTask);\
+	else {\
+		if (pTask->free_data)\
+			pTask->free_data (pTask->pSharedMemory);\
+		pTask->free_data = NULL;\
+		pTask->pSharedMemory = NULL;\
+		g_atomic_int_set (&pTask->bDiscard, 1); } } while (0)
+
+typedef struct {
+	GldiTask *pTask;
+	guint iLaunchId;  // ID of the task when it was launched; if it differs from the current one, the launch is outdated.
+	} GldiTaskLaunch;
+
+static gint _compare_dates (GldiTask *pTask1, GldiTask *pTask2)
 {
-	gldi_task_launch (pTask);
-	return TRUE;
+	return (pTask1->iNextIteration < pTask2->iNextIteration ? -1 : pTask1->iNextIteration > pTask2->iNextIteration ? 1 : 0);
 }
-static gboolean _check_for_update_idle (GldiTask *pTask)
+static gboolean _on_schedule_timer (gpointer data);
+static void _set_schedule_timer (void)
 {
-	// process the data (we don't need to wait that the thread is over, so do it now, it will let more time for the thread to finish, and therfore often save a 'usleep').
-	if (pTask->bNeedsUpdate)  // data are ready to be processed -> perform the update
+	if (s_pScheduledTasks == NULL)  // no more periodic task -> no more wake-up
 	{
-		if (! pTask->bDiscard)  // of course if the task has been discarded before, don't do anything.
+		if (s_iSidScheduleTimer != 0)
 		{
-			pTask->bContinue = pTask->update (pTask->pSharedMemory);
+			g_source_remove (s_iSidScheduleTimer);
+			s_iSidScheduleTimer = 0;
 		}
-		pTask->bNeedsUpdate = FALSE;  // now update is done, we won't do it any more until the next iteration, even is we loop on this function.
+		return;
 	}
 	
-	// finish the iteration, and possibly schedule the next one (the thread must be finished for this part).
-	if (g_mutex_trylock (pTask->pMutex))  // if the thread is over
+	GldiTask *pFirstTask = s_pScheduledTasks->data;
+	if (s_iSidScheduleTimer != 0 && s_iScheduleTimerDate == pFirstTask->iNextIteration)  // already set on the right date
+		return;
+	
+	if (s_iSidScheduleTimer != 0)
+		g_source_remove (s_iSidScheduleTimer);
+	gint64 iDelay = pFirstTask->iNextIteration - g_get_monotonic_time ();  // in us
+	s_iScheduleTimerDate = pFirstTask->iNextIteration;
+	s_iSidScheduleTimer = g_timeout_add (iDelay > 0 ? (iDelay + 999) / 1000 : 0, _on_schedule_timer, NULL);
+}
+static void _insert_task (GldiTask *pTask, gint64 iDate)
+{
+	pTask->iNextIteration = iDate;
+	s_pScheduledTasks = g_list_insert_sorted (s_pScheduledTasks, pTask, (GCompareFunc) _compare_dates);
+}
+static void _schedule_task (GldiTask *pTask, int iPeriod)
+{
+	pTask->iSchedulePeriod = iPeriod;
+	_insert_task (pTask, g_get_monotonic_time () + (gint64)iPeriod * G_USEC_PER_SEC);
+	_set_schedule_timer ();
+}
+static void _unschedule_task (GldiTask *pTask)
+{
+	if (pTask->iNextIteration == 0)
+		return;
+	s_pScheduledTasks = g_list_remove (s_pScheduledTasks, pTask);
+	pTask->iNextIteration = 0;
+	_set_schedule_timer ();
+}
+static gboolean _on_schedule_timer (G_GNUC_UNUSED gpointer data)
+{
+	s_iSidScheduleTimer = 0;
+	gint64 iNow = g_get_monotonic_time ();
+	gint64 iDeadline = iNow + (gint64)myTasksParam.iTimerSlack * 1000;  // tasks due a bit later are launched now, to save a wake-up.
+	
+	// launch the tasks one by one, since a task can stop or destroy another one.
+	GldiTask *pTask;
+	while (s_pScheduledTasks != NULL && (pTask = s_pScheduledTasks->data)->iNextIteration <= iDeadline)
 	{
-		if (pTask->bDiscard)  // if the task has been discarded, it's the end of the journey for it.
-		{
-			if (pTask->pCond)
-			{
-				pTask->bRunThread = TRUE;
-				g_cond_signal (pTask->pCond);
-				g_mutex_unlock (pTask->pMutex);
-				g_thread_join (pTask->pThread); // unref the thread
-			}
-			else
-			{
-				g_mutex_unlock (pTask->pMutex);
-				G_THREAD_UNREF (pTask->pThread);
-			}
-			pTask->pThread = NULL;
-			_free_task (pTask);
-			return FALSE;
-		}
+		s_pScheduledTasks = g_list_delete_link (s_pScheduledTasks, s_pScheduledTasks);
 		
-		if (! pTask->pCond)  // one-shot thread => the thread is over
-		{
-			G_THREAD_UNREF (pTask->pThread);
-			pTask->pThread = NULL;
-		}
-		
-		pTask->iSidUpdateIdle = 0;  // set it before the unlock, as it is accessed in the thread part
-		g_mutex_unlock (pTask->pMutex);
+		// schedule the next iteration, like a periodic timer would do.
+		gint64 iNextDate = pTask->iNextIteration + (gint64)pTask->iSchedulePeriod * G_USEC_PER_SEC;
+		if (iNextDate <= iDeadline)  // we are late (the computer was suspended, or the main loop was blocked) -> don't launch several iterations in a row; since the slack is lower than the period (1s at least), the task is then not due again in this loop.
+			iNextDate = iNow + (gint64)pTask->iSchedulePeriod * G_USEC_PER_SEC;
+		_insert_task (pTask, iNextDate);
 		
-		// schedule the next iteration if necessary.
-		if (! pTask->bContinue)
-		{
-			_cancel_next_iteration (pTask);
-		}
-		else
+		gldi_task_launch (pTask);
+	}
+	
+	_set_schedule_timer ();
+	return FALSE;
+}
+static void _finish_task (GldiTaskLaunch *pLaunch)
+{
+	GldiTask *pTask = pLaunch->pTask;
+	gboolean bOutdated = (pLaunch->iLaunchId != pTask->iLaunchId);
+	g_free (pLaunch);
+	
+	// the worker has queued us just before releasing the task, so this lock won't last.
+	g_mutex_lock (pTask->pMutex);
+	g_mutex_unlock (pTask->pMutex);
+	pTask->iNbLaunches --;
+	
+	// the task has been stopped since this launch: there is nothing to update, but it may be waiting for us to be freed.
+	if (bOutdated)
+	{
+		if (pTask->bDiscard && pTask->iNbLaunches == 0 && ! pTask->bIsRunning)
+			_free_task (pTask);
+		return;
+	}
+	
+	// process the data.
+	if (pTask->bNeedsUpdate)  // data are ready to be processed -> perform the update
+	{
+		if (! pTask->bDiscard)  // of course if the task has been discarded before, don't do anything.
 		{
-			pTask->iFrequencyState = GLDI_TASK_FREQUENCY_NORMAL;
-			_schedule_next_iteration (pTask);
+			pTask->bContinue = pTask->update (pTask->pSharedMemory);
 		}
+		pTask->bNeedsUpdate = FALSE;
+	}
+	
+	// if the task has been discarded (possibly during the 'update'), it's the end of the journey for it.
+	if (pTask->bDiscard)
+	{
 		pTask->bIsRunning = FALSE;
-		return FALSE;  // the update is now finished, quit.
+		_free_task_when_possible (pTask);
+		return;
 	}
 	
-	// if the thread is not yet over, come back in 1ms.
-	g_usleep (1);  // we don't want to block the main loop until the thread is over; so just sleep 1ms to give it a chance to terminate. so it's a kind of 'sched_yield()' wihout blocking the main loop.
+	// schedule the next iteration if necessary.
+	if (! pTask->bContinue)
+	{
+		_cancel_next_iteration (pTask);
+	}
+	else
+	{
+		pTask->iFrequencyState = GLDI_TASK_FREQUENCY_NORMAL;
+		_schedule_next_iteration (pTask);
+	}
+	pTask->bIsRunning = FALSE;
+}
+static gboolean _has_completed_tasks (void)
+{
+	g_mutex_lock (s_pCompletedTasksMutex);
+	gboolean bHasTasks = ! g_queue_is_empty (s_pCompletedTasks);
+	g_mutex_unlock (s_pCompletedTasksMutex);
+	return bHasTasks;
+}
+static gboolean _completion_prepare (G_GNUC_UNUSED GSource *pSource, gint *iTimeout)
+{
+	*iTimeout = -1;  // no need to poll, the workers wake the main loop up when they queue a task.
+	return _has_completed_tasks ();
+}
+static gboolean _completion_check (G_GNUC_UNUSED GSource *pSource)
+{
+	return _has_completed_tasks ();
+}
+static gboolean _completion_dispatch (G_GNUC_UNUSED GSource *pSource, G_GNUC_UNUSED GSourceFunc callback, G_GNUC_UNUSED gpointer data)
+{
+	GldiTaskLaunch *pLaunch;
+	do  // pop the tasks one by one, since an 'update' can stop or destroy another task of the queue.
+	{
+		g_mutex_lock (s_pCompletedTasksMutex);
+		pLaunch = g_queue_pop_head (s_pCompletedTasks);
+		g_mutex_unlock (s_pCompletedTasksMutex);
+		if (pLaunch != NULL)
+			_finish_task (pLaunch);
+	} while (pLaunch != NULL);
 	return TRUE;
 }
-static gpointer _get_data_threaded (GldiTask *pTask)
+static GSourceFuncs s_CompletionSourceFuncs = {
+	_completion_prepare,
+	_completion_check,
+	_completion_dispatch,
+	NULL,
+	NULL,
+	NULL
+};
+static void _get_data_threaded (GldiTaskLaunch *pLaunch, G_GNUC_UNUSED gpointer data)
 {
+	GldiTask *pTask = pLaunch->pTask;  // the task can't be freed before this launch is finished.
 	g_mutex_lock (pTask->pMutex);
-	_run_thread:  // at this point the mutex is locked, either by the first execution of this function, or by 'g_cond_wait'
 	
-	//\_______________________ get the data
-	_set_elapsed_time (pTask);
-	pTask->get_data (pTask->pSharedMemory);
+	//\_______________________ get the data, unless the task has been stopped or discarded while it was waiting in the pool.
+	if (pLaunch->iLaunchId == pTask->iLaunchId && g_atomic_int_get (&pTask->bDiscard) == 0)
+	{
+		_set_elapsed_time (pTask);
+		pTask->get_data (pTask->pSharedMemory);
+		
+		// and signal that data are ready to be processed.
+		pTask->bNeedsUpdate = TRUE;
+	}
 	
-	// and signal that data are ready to be processed.
-	pTask->bNeedsUpdate = TRUE;  // this is only accessed by the update fonction, which is triggered just after, so no need to protect this variable.
+	//\_______________________ queue the task for its update and wake the main loop up, then release the task.
+	g_mutex_lock (s_pCompletedTasksMutex);  // done while the task is locked, so that 'gldi_task_stop' always finds it in the queue.
+	g_queue_push_tail (s_pCompletedTasks, pLaunch);
+	g_mutex_unlock (s_pCompletedTasksMutex);
+	g_main_context_wakeup (NULL);
 	
-	//\_______________________ call the update function from the main loop
-	if (pTask->iSidUpdateIdle == 0)
-		pTask->iSidUpdateIdle = g_idle_add ((GSourceFunc) _check_for_update_idle, pTask);  // note that 'iSidUpdateIdle' can actually be set after the 'update' is called. that's why the 'update' have to wait for the mutex to finish its job.
+	g_mutex_unlock (pTask->pMutex);
+}
+static int _get_nb_threads (void)
+{
+	int iNbThreads = myTasksParam.iNbThreads;
+	if (iNbThreads <= 0)  // automatic: enough threads to not be blocked by a slow download, and no more than the CPU can run in parallel on a big machine.
+	{
+		#if GLIB_CHECK_VERSION (2, 36, 0)
+		iNbThreads = MAX (4, g_get_num_processors ());
+		#else
+		iNbThreads = 4;
+		#endif
+	}
+	return iNbThreads;
+}
+static void _create_pool (void)
+{
+	s_pCompletedTasks = g_queue_new ();
+	G_MUTEX_INIT (s_pCompletedTasksMutex);
+	s_pCompletionSource = g_source_new (&s_CompletionSourceFuncs, sizeof (GSource));
+	g_source_set_priority (s_pCompletionSource, G_PRIORITY_DEFAULT_IDLE);  // updates are processed when the main loop is idle, as before.
+	g_source_attach (s_pCompletionSource, NULL);
 	
-	// sleep until the next iteration or just leave.
-	if (pTask->pCond)  // periodic task -> block until the condition becomes TRUE again.
+	GError *erreur = NULL;
+	s_pTaskPool = g_thread_pool_new ((GFunc) _get_data_threaded,
+		NULL,
+		_get_nb_threads (),
+		FALSE,  // not exclusive: threads are only spawned when needed, and the unused ones are released after a while.
+		&erreur);
+	if (erreur != NULL)
 	{
-		pTask->bRunThread = FALSE;
-		while (! pTask->bRunThread)
-			g_cond_wait (pTask->pCond, pTask->pMutex);  // releases the mutex, then takes it again when awakening.
-		if (g_atomic_int_get (&pTask->bDiscard) == 0)
-			goto _run_thread;
+		cd_warning (erreur->message);
+		g_error_free (erreur);
 	}
-	g_mutex_unlock (pTask->pMutex);
-	g_thread_exit (NULL);
-	return NULL;
 }
 void gldi_task_launch (GldiTask *pTask)
 {
@@ -172,36 +314,25 @@ void gldi_task_launch (GldiTask *pTask)
 			_schedule_next_iteration (pTask);
 		}
 	}
-	else  // launch the asynchronous work in a thread
+	else if (! pTask->bIsRunning)  // neither in the pool nor waiting for the update -> push it into the pool.
 	{
-		if (pTask->pThread == NULL)  // no thread yet -> create and launch it
+		if (s_pTaskPool == NULL)
+			_create_pool ();
+		g_return_if_fail (s_pTaskPool != NULL);
+		
+		GldiTaskLaunch *pLaunch = g_new (GldiTaskLaunch, 1);
+		pLaunch->pTask = pTask;
+		pLaunch->iLaunchId = pTask->iLaunchId;  // only changed by the main thread, so no need to lock.
+		pTask->bIsRunning = TRUE;
+		pTask->iNbLaunches ++;
+		GError *erreur = NULL;
+		g_thread_pool_push (s_pTaskPool, pLaunch, &erreur);
+		if (erreur != NULL)  // no new thread could be created; the task stays in the queue until a thread of the pool is available.
 		{
-			pTask->bIsRunning = TRUE;
-			GError *erreur = NULL;
-			#ifndef GLIB_VERSION_2_32
-			pTask->pThread = g_thread_create ((GThreadFunc) _get_data_threaded, pTask, TRUE, &erreur);  // TRUE <=> joinable
-			#else
-			pTask->pThread = g_thread_try_new ("Cairo-Dock Task", (GThreadFunc) _get_data_threaded, pTask, &erreur);
-			#endif
-			if (erreur != NULL)  // on n'a pas pu lancer le thread.
-			{
-				cd_warning (erreur->message);
-				g_error_free (erreur);
-				pTask->bIsRunning = FALSE;
-			}
+			cd_warning (erreur->message);
+			g_error_free (erreur);
 		}
-		else  // thread already exists; it's either running or sleeping or finished with a pending update
-		if (pTask->pCond && g_mutex_trylock (pTask->pMutex))  // it's a periodic thread, and it's not currently running...
-		{
-			if (pTask->iSidUpdateIdle == 0)  // ...and it doesn't have a pending update -> awake it and run it again.
-			{
-				pTask->bRunThread = TRUE;
-				pTask->bIsRunning = TRUE;
-				g_cond_signal (pTask->pCond);
-			}
-			g_mutex_unlock (pTask->pMutex);
-		}  // else it's a one-shot thread or it's currently running or has a pending update -> don't launch it. so if the task is periodic, it will skip this iteration.
-	}
+	}  // else it's currently in the pool or has a pending update -> don't launch it. so if the task is periodic, it will skip this iteration.
 }
 
 
@@ -231,10 +362,6 @@ GldiTask *gldi_task_new_full (int iPeriod, GldiGetDataAsyncFunc get_data, GldiUp
 	pTask->pSharedMemory = pSharedMemory;
 	pTask->pClock = g_timer_new ();
 	G_MUTEX_INIT (pTask->pMutex);
-	if (iPeriod != 0)
-	{
-		G_COND_INIT (pTask->pCond);
-	}
 	return pTask;
 }
 
@@ -248,42 +375,15 @@ void gldi_task_stop (GldiTask *pTask)
 	
 	if (gldi_task_is_running (pTask))
 	{
-		if (pTask->pThread)
-		{
-			g_atomic_int_set (&pTask->bDiscard, 1);  // set the discard flag to help the 'get_data' callback knows that it should stop.
-			if (pTask->pCond)  // the thread might be sleeping, awake it.
-			{
-				if (g_mutex_trylock (pTask->pMutex))
-				{
-					pTask->bRunThread = TRUE;
-					g_cond_signal (pTask->pCond);
-					g_mutex_unlock (pTask->pMutex);
-				}
-			}
-			g_thread_join (pTask->pThread);  // unref the thread
-			pTask->pThread = NULL;
-			g_atomic_int_set (&pTask->bDiscard, 0);
-		}
-		if (pTask->iSidUpdateIdle != 0)  // do it after the thread has possibly scheduled the 'update'
-		{
-			g_source_remove (pTask->iSidUpdateIdle);
-			pTask->iSidUpdateIdle = 0;
-		}
+		g_atomic_int_set (&pTask->bDiscard, 1);  // set the discard flag to help the 'get_data' callback knows that it should stop.
+		g_mutex_lock (pTask->pMutex);  // only blocks if the 'get_data' is being executed; a launch still waiting for a thread doesn't hold the mutex.
+		pTask->iLaunchId ++;  // the current launch is now outdated: its 'get_data' will be skipped if it has not started yet, and its 'update' won't be done.
+		g_mutex_unlock (pTask->pMutex);
+		g_atomic_int_set (&pTask->bDiscard, 0);
+		
+		pTask->bNeedsUpdate = FALSE;
 		pTask->bIsRunning = FALSE;  // since we didn't go through the 'update'
 	}
-	else
-	{
-		if (pTask->pThread && pTask->pCond && g_mutex_trylock (pTask->pMutex))  // the thread is sleeping, awake it and let it exit.
-		{
-			g_atomic_int_set (&pTask->bDiscard, 1);
-			pTask->bRunThread = TRUE;
-			g_cond_signal (pTask->pCond);
-			g_mutex_unlock (pTask->pMutex);
-			g_thread_join (pTask->pThread);  // unref the thread
-			pTask->pThread = NULL;
-			g_atomic_int_set (&pTask->bDiscard, 0);
-		}
-	}
 }
 
 
@@ -297,20 +397,12 @@ void gldi_task_discard (GldiTask *pTask)
 	g_atomic_int_set (&pTask->bDiscard, 1);
 	
 	// if the task is running, there is nothing to do:
-	//   if we're inside the thread, it will trigger the 'update' anyway, which will destroy the task.
+	//   if it's in the pool, the worker will queue the 'update' anyway, which will destroy the task.
 	//   if we're waiting for the 'update', same as above
 	//   if we're inside the 'update' user callback, the task will be destroyed in the 2nd stage of the function (the user callback is called in the 1st stage).
-	if (! gldi_task_is_running (pTask))  // we can free the task immediately.
+	if (! gldi_task_is_running (pTask))  // we can free the task immediately (or at least its data, if some outdated launches are still in the pool).
 	{
-		if (pTask->pThread && pTask->pCond && g_mutex_trylock (pTask->pMutex))  // the thread is sleeping, awake it and let it exit before we can free everything
-		{
-			pTask->bRunThread = TRUE;
-			g_cond_signal (pTask->pCond);
-			g_mutex_unlock (pTask->pMutex);
-			g_thread_join (pTask->pThread);  // unref the thread
-			pTask->pThread = NULL;
-		}
-		_free_task (pTask);
+		_free_task_when_possible (pTask);
 	}
 }
 
@@ -320,12 +412,12 @@ void gldi_task_free (GldiTask *pTask)
 		return ;
 	
 	gldi_task_stop (pTask);
-	_free_task (pTask);
+	_free_task_when_possible (pTask);
 }
 
 gboolean gldi_task_is_active (GldiTask *pTask)
 {
-	return (pTask != NULL && pTask->iSidTimer != 0);
+	return (pTask != NULL && (pTask->iSidTimer != 0 || pTask->iNextIteration != 0));
 }
 
 gboolean gldi_task_is_running (GldiTask *pTask)
@@ -335,11 +427,11 @@ gboolean gldi_task_is_running (GldiTask *pTask)
 
 static void _restart_timer_with_frequency (GldiTask *pTask, int iNewPeriod)
 {
-	gboolean bNeedsRestart = (pTask->iSidTimer != 0);
+	gboolean bNeedsRestart = gldi_task_is_active (pTask);
 	_cancel_next_iteration (pTask);
 	
 	if (bNeedsRestart && iNewPeriod != 0)
-		pTask->iSidTimer = g_timeout_add_seconds (iNewPeriod, (GSourceFunc) _launch_task_timer, pTask);
+		_schedule_task (pTask, iNewPeriod);
 }
 
 void gldi_task_change_frequency (GldiTask *pTask, int iNewPeriod)
@@ -393,3 +485,67 @@ void gldi_task_set_normal_frequency (GldiTask *pTask)
 		_restart_timer_with_frequency (pTask, pTask->iPeriod);
 	}
 }
+
+
+  //////////////////
+ /// GET CONFIG ///
+//////////////////
+
+static gboolean get_config (GKeyFile *pKeyFile, GldiTasksParam *pTasksParam)
+{
+	gboolean bFlushConfFileNeeded = FALSE;
+	
+	pTasksParam->iNbThreads = cairo_dock_get_integer_key_value (pKeyFile, "System", "task threads", &bFlushConfFileNeeded, 0, NULL, NULL);
+	
+	pTasksParam->iTimerSlack = cairo_dock_get_integer_key_value (pKeyFile, "System", "task timer slack", &bFlushConfFileNeeded, 500, NULL, NULL);
+	pTasksParam->iTimerSlack = CLAMP (pTasksParam->iTimerSlack, 0, 999);  // must stay below the smallest period (1s).
+	
+	return bFlushConfFileNeeded;
+}
+
+  ////////////
+ /// LOAD ///
+////////////
+
+static void load (void)
+{
+	if (s_pTaskPool != NULL)  // some tasks may have been launched before the config was read (by the 'init' of the managers).
+		g_thread_pool_set_max_threads (s_pTaskPool, _get_nb_threads (), NULL);
+}
+
+  //////////////
+ /// RELOAD ///
+//////////////
+
+static void reload (GldiTasksParam *pPrevTasksParam, GldiTasksParam *pTasksParam)
+{
+	if (pPrevTasksParam->iNbThreads != pTasksParam->iNbThreads && s_pTaskPool != NULL)
+	{
+		g_thread_pool_set_max_threads (s_pTaskPool, _get_nb_threads (), NULL);
+	}
+}
+
+  ///////////////
+ /// MANAGER ///
+///////////////
+
+void gldi_register_tasks_manager (void)
+{
+	// Manager
+	memset (&myTasksMgr, 0, sizeof (GldiManager));
+	gldi_object_init (GLDI_OBJECT(&myTasksMgr), &myManagerObjectMgr, NULL);
+	myTasksMgr.cModuleName  = "Tasks";
+	// interface
+	myTasksMgr.init         = NULL;
+	myTasksMgr.load         = load;
+	myTasksMgr.unload       = NULL;
+	myTasksMgr.reload       = (GldiManagerReloadFunc)reload;
+	myTasksMgr.get_config   = (GldiManagerGetConfigFunc)get_config;
+	myTasksMgr.reset_config = (GldiManagerResetConfigFunc)NULL;
+	// Config
+	myTasksMgr.pConfig = (GldiManagerConfigPtr)&myTasksParam;
+	myTasksMgr.iSizeOfConfig = sizeof (GldiTasksParam);
+	// data
+	myTasksMgr.pData = (GldiManagerDataPtr)NULL;
+	myTasksMgr.iSizeOfData = 0;
+}
@@ -21,6 +21,7 @@
 #define  __CAIRO_DOCK_TASK__
 
 #include "cairo-dock-struct.h"
+#include "cairo-dock-manager.h"
 G_BEGIN_DECLS
 
 /**
@@ -28,6 +29,7 @@ G_BEGIN_DECLS
  *
  *  A Task is divided in 2 phases : 
  * - the asynchronous phase will be executed in another thread, while the dock continues to run on its own thread, in parallel. During this phase you will do all the heavy job (like downloading a file or computing something) but you can't interact on the dock.
+ *   The threads are not owned by the Tasks: they are taken from a pool shared by all the Tasks, whose size can be set in the config ("System" group).
  * - the synchronous phase will be executed after the first one has finished. There you will update your applet with the result of the first phase.
  * 
  * \attention A data buffer is used to communicate between the 2 phases. It is important that these datas are never accessed outside the task, and vice versa that the asynchronous thread never accesses other data than this buffer.\n
@@ -35,10 +37,24 @@ G_BEGIN_DECLS
  * 
  * You create a Task with \ref gldi_task_new, launch it with \ref gldi_task_launch, and destroy it with \ref gldi_task_free or \ref gldi_task_discard.
  *
- * A Task can be periodic if you specify a period, otherwise it will be executed once. It also can also be fully synchronous if you don't specify an asynchronous function.
+ * A Task can be periodic if you specify a period, otherwise it will be executed once. All the periodic Tasks share a single timer, and the ones that are due within a short delay are launched together, to save wake-ups. It also can also be fully synchronous if you don't specify an asynchronous function.
  * 
  */
 
+// manager
+typedef struct _GldiTasksParam GldiTasksParam;
+
+#ifndef _MANAGER_DEF_
+extern GldiTasksParam myTasksParam;
+extern GldiManager myTasksMgr;
+#endif
+
+// params
+struct _GldiTasksParam {
+	gint iNbThreads;  // maximum number of threads of the pool, 0 means automatic.
+	gint iTimerSlack;  // delay in ms by which a periodic task can be launched in advance, to share the wake-up with another one.
+	};
+
 // Type of frequency for a periodic task. The frequency of the Task is divided by 2, 4, and 10 for each state.
 typedef enum {
 	GLDI_TASK_FREQUENCY_NORMAL = 0,
@@ -55,7 +71,7 @@ typedef gboolean (* GldiUpdateSyncFunc ) (gpointer pSharedMemory);
 
 /// Definition of a periodic and/or asynchronous Task.
 struct _GldiTask {
-	// ID of the timer of the Task (if periodic)
+	// ID of the timer of the Task, when it's launched with a delay.
 	gint iSidTimer;
 	// TRUE if the thread is running or about to run or if the update is pending
 	gboolean bIsRunning;
@@ -76,16 +92,19 @@ struct _GldiTask {
 	// below are the parameters accessed inside the thread => only between mutex lock/unlock
 	/// structure passed as parameter of the 'get_data' and 'update' functions. Must not be accessed outside of these 2 functions !
 	gpointer pSharedMemory;
-	// ID of the idle source to perform the update.
-	gint iSidUpdateIdle;
+	// ID of the current launch; stopping the Task changes it, so that a launch still waiting in the pool is skipped.
+	guint iLaunchId;
 	/// TRUE when the task has been discarded.
 	gboolean bDiscard;
 	gboolean bNeedsUpdate;  // TRUE when new data are waiting to be processed.
 	gboolean bContinue;  // result of the 'update' function (TRUE -> continue, FALSE -> stop, if the task is periodic).
-	GThread *pThread;  // the thread that execute the asynchronous 'get_data' callback
-	GCond *pCond;  // condition to awake the thread (if periodic).
-	gboolean bRunThread;  // condition value: whether to run the thread or exit.
-	GMutex *pMutex;  // mutex associated with the condition.
+	gpointer unused[2];  // keep ABI compatibility
+	gint iNbLaunches;  // number of launches pushed into the pool and not yet finished (outdated ones included); the Task can't be freed before.
+	GMutex *pMutex;  // held by the pool while the 'get_data' callback is executed.
+	// monotonic date (in us) of the next iteration of the Task (if periodic), 0 if not scheduled.
+	gint64 iNextIteration;
+	// current period (in s) of the iterations, which can differ from the period of the Task when its frequency is downgraded.
+	guint iSchedulePeriod;
 } ;
 
 
@@ -171,5 +190,8 @@ void gldi_task_set_normal_frequency (GldiTask *pTask);
 */
 #define gldi_task_get_elapsed_time(pTask) (pTask->fElapsedTime)
 
+
+void gldi_register_tasks_manager (void);
+
 G_END_DECLS
 #endif
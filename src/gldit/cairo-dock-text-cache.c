@@ -0,0 +1,197 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "cairo-dock-log.h"
+#include "cairo-dock-surface-factory.h"  // cairo_dock_create_surface_from_text_full
+#include "cairo-dock-draw-opengl.h"  // cairo_dock_create_texture_from_surface
+#include "cairo-dock-style-facility.h"  // GldiTextDescription
+#include "cairo-dock-image-buffer.h"
+#include "cairo-dock-text-cache.h"
+
+#define GLDI_TEXT_CACHE_MAX_SIZE (4 * 1024 * 1024)  // in bytes; about 200 quick-infos or labels.
+
+typedef struct {
+	gchar *cKey;
+	cairo_surface_t *pSurface;
+	GLuint iTexture;
+	gint iWidth;
+	gint iHeight;
+	gint iRefCount;  // 1 per ImageBuffer that displays it, + 1 while it's in the cache.
+	GList link;  // its place in the LRU queue, while it's in the cache.
+	} GldiTextCacheEntry;
+
+extern gboolean g_bUseOpenGL;
+
+static GHashTable *s_hEntries = NULL;  // key -> entry
+static GHashTable *s_hImages = NULL;  // ImageBuffer -> entry it displays; kept here rather than in the ImageBuffer, so that its structure doesn't change.
+static GQueue s_lru = G_QUEUE_INIT;  // most recently used entry first.
+static gsize s_iCacheSize = 0;  // in bytes
+static guint s_iNbHits = 0;
+static guint s_iNbMisses = 0;
+
+
+static gchar *_make_key (const gchar *cText, GldiTextDescription *pTextDescription, double fMaxScale, int iMaxWidth)
+{
+	// the values of the description are part of the key; the default colors (bUseDefaultColors) come from the style, so the cache is cleared when it changes.
+	const GdkRGBA *t = &pTextDescription->fColorStart.rgba, *b = &pTextDescription->fBackgroundColor.rgba, *l = &pTextDescription->fLineColor.rgba;
+	return g_strdup_printf ("%s|%d|%d%d%d%d|%d|%.3f|%.3f|%d|%.3f,%.3f,%.3f,%.3f|%.3f,%.3f,%.3f,%.3f|%.3f,%.3f,%.3f,%.3f|%s",
+		pTextDescription->cFont ? pTextDescription->cFont : "",
+		pTextDescription->iSize,
+		pTextDescription->bNoDecorations, pTextDescription->bUseDefaultColors, pTextDescription->bOutlined, pTextDescription->bUseMarkup,
+		pTextDescription->iMargin,
+		pTextDescription->fMaxRelativeWidth,
+		fMaxScale,
+		iMaxWidth,
+		t->red, t->green, t->blue, t->alpha,
+		b->red, b->green, b->blue, b->alpha,
+		l->red, l->green, l->blue, l->alpha,
+		cText);  // the text last, so that it can contain any character.
+}
+
+static void _unref_entry (GldiTextCacheEntry *pEntry)
+{
+	pEntry->iRefCount --;
+	if (pEntry->iRefCount > 0)
+		return;
+	if (pEntry->pSurface != NULL)
+		cairo_surface_destroy (pEntry->pSurface);
+	if (pEntry->iTexture != 0)
+		_cairo_dock_delete_texture (pEntry->iTexture);
+	g_free (pEntry->cKey);
+	g_free (pEntry);
+}
+
+static void _remove_entry (GldiTextCacheEntry *pEntry)
+{
+	g_queue_unlink (&s_lru, &pEntry->link);
+	g_hash_table_remove (s_hEntries, pEntry->cKey);  // the table doesn't own the key nor the entry.
+	s_iCacheSize -= pEntry->iWidth * pEntry->iHeight * 4;
+	_unref_entry (pEntry);
+}
+
+static GldiTextCacheEntry *_get_entry (const gchar *cText, GldiTextDescription *pTextDescription, double fMaxScale, int iMaxWidth)
+{
+	if (s_hEntries == NULL)
+		s_hEntries = g_hash_table_new (g_str_hash, g_str_equal);
+	
+	gchar *cKey = _make_key (cText, pTextDescription, fMaxScale, iMaxWidth);
+	GldiTextCacheEntry *pEntry = g_hash_table_lookup (s_hEntries, cKey);
+	if (pEntry != NULL)  // already rendered, just move it at the head of the queue.
+	{
+		g_free (cKey);
+		s_iNbHits ++;
+		g_queue_unlink (&s_lru, &pEntry->link);
+		g_queue_push_head_link (&s_lru, &pEntry->link);
+		return pEntry;
+	}
+	s_iNbMisses ++;
+	
+	//\_______________ render the text.
+	int iWidth = 0, iHeight = 0;
+	cairo_surface_t *pSurface = cairo_dock_create_surface_from_text_full (cText,
+		pTextDescription,
+		fMaxScale,
+		iMaxWidth,
+		&iWidth, &iHeight);
+	if (pSurface == NULL || iWidth == 0 || iHeight == 0)
+	{
+		if (pSurface != NULL)
+			cairo_surface_destroy (pSurface);
+		g_free (cKey);
+		return NULL;
+	}
+	
+	pEntry = g_new0 (GldiTextCacheEntry, 1);
+	pEntry->cKey = cKey;
+	pEntry->pSurface = pSurface;
+	pEntry->iWidth = iWidth;
+	pEntry->iHeight = iHeight;
+	pEntry->iRefCount = 1;  // the cache's reference.
+	pEntry->link.data = pEntry;
+	if (g_bUseOpenGL)
+		pEntry->iTexture = cairo_dock_create_texture_from_surface (pSurface);
+	
+	g_hash_table_insert (s_hEntries, cKey, pEntry);
+	g_queue_push_head_link (&s_lru, &pEntry->link);
+	s_iCacheSize += iWidth * iHeight * 4;
+	
+	//\_______________ make some room, keeping at least the new entry.
+	GList *pLastLink;
+	while (s_iCacheSize > GLDI_TEXT_CACHE_MAX_SIZE && (pLastLink = g_queue_peek_tail_link (&s_lru)) != &pEntry->link)
+	{
+		_remove_entry (pLastLink->data);
+	}
+	return pEntry;
+}
+
+
+void gldi_text_cache_load_image_buffer (CairoDockImageBuffer *pImage, const gchar *cText, GldiTextDescription *pTextDescription, double fMaxScale, int iMaxWidth)
+{
+	g_return_if_fail (pImage != NULL && cText != NULL && pTextDescription != NULL);
+	GldiTextCacheEntry *pEntry = _get_entry (cText, pTextDescription, fMaxScale, iMaxWidth);
+	if (pEntry == NULL)
+		return;
+	
+	if (s_hImages == NULL)
+		s_hImages = g_hash_table_new (g_direct_hash, g_direct_equal);
+	GldiTextCacheEntry *pPrevEntry = g_hash_table_lookup (s_hImages, pImage);
+	if (pPrevEntry != NULL)  // the image was not released (it should have been unloaded before), just drop its previous entry.
+		_unref_entry (pPrevEntry);
+	
+	pEntry->iRefCount ++;
+	g_hash_table_insert (s_hImages, pImage, pEntry);
+	pImage->pSurface = pEntry->pSurface;
+	pImage->iTexture = pEntry->iTexture;
+	pImage->iWidth = pEntry->iWidth;
+	pImage->iHeight = pEntry->iHeight;
+	pImage->fZoomX = 1.;
+	pImage->fZoomY = 1.;  // the image is not packed into the atlas, since it would mean an upload for each ImageBuffer.
+}
+
+void gldi_text_cache_release_image_buffer (CairoDockImageBuffer *pImage)
+{
+	GldiTextCacheEntry *pEntry = (s_hImages != NULL ? g_hash_table_lookup (s_hImages, pImage) : NULL);
+	if (pEntry == NULL)
+		return;
+	g_hash_table_remove (s_hImages, pImage);
+	if (pImage->pSurface == pEntry->pSurface && pImage->iTexture == pEntry->iTexture)  // otherwise the image has been reloaded with something else, which belongs to it.
+	{
+		pImage->pSurface = NULL;
+		pImage->iTexture = 0;
+	}
+	_unref_entry (pEntry);
+}
+
+void gldi_text_cache_clear (void)
+{
+	cd_debug ("text cache: %u hits, %u misses, %lu bytes", s_iNbHits, s_iNbMisses, (gulong) s_iCacheSize);
+	GList *pLastLink;
+	while ((pLastLink = g_queue_peek_tail_link (&s_lru)) != NULL)
+	{
+		_remove_entry (pLastLink->data);
+	}
+}
+
+void gldi_text_cache_get_stats (guint *iNbHits, guint *iNbMisses)
+{
+	if (iNbHits)
+		*iNbHits = s_iNbHits;
+	if (iNbMisses)
+		*iNbMisses = s_iNbMisses;
+}
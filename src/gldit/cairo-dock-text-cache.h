@@ -0,0 +1,59 @@
+/*
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __CAIRO_DOCK_TEXT_CACHE__
+#define  __CAIRO_DOCK_TEXT_CACHE__
+
+#include <glib.h>
+
+#include "cairo-dock-struct.h"
+G_BEGIN_DECLS
+
+/**
+*@file cairo-dock-text-cache.h This class keeps the images of the texts recently rendered for the icons (labels and quick-infos), so that displaying a text again (a clock, a counter cycling between a few values, a window title that toggles) doesn't run Pango and upload a new texture each time.
+* An entry is identified by the text, its description, the max scale and the width limit it was rendered with. Its surface and texture are shared by all the ImageBuffers that display it, and are freed when the last of them is unloaded; the images that are kept in the cache are limited in size, the least recently used ones are dropped first.
+*/
+
+/** Load a text into an ImageBuffer, taking its image from the cache if possible. The ImageBuffer must be empty, and is unloaded as usual with \ref cairo_dock_unload_image_buffer.
+*@param pImage an ImageBuffer.
+*@param cText the text.
+*@param pTextDescription description of the text.
+*@param fMaxScale maximum scale the text will be drawn at.
+*@param iMaxWidth maximum width of the text, 0 for no limit.
+*/
+void gldi_text_cache_load_image_buffer (CairoDockImageBuffer *pImage, const gchar *cText, GldiTextDescription *pTextDescription, double fMaxScale, int iMaxWidth);
+
+/** Release the entry displayed by an ImageBuffer. It's done by \ref cairo_dock_unload_image_buffer, you shouldn't need to call it.
+*@param pImage an ImageBuffer loaded with \ref gldi_text_cache_load_image_buffer.
+*/
+void gldi_text_cache_release_image_buffer (CairoDockImageBuffer *pImage);
+
+/** Remove all the entries of the cache. The images currently displayed stay valid. Call it when the default style changes, since it's not part of the entries' key.
+*/
+void gldi_text_cache_clear (void);
+
+/** Get the number of lookups that found their text in the cache, and the number of those that had to render it.
+*@param iNbHits will be filled with the number of hits.
+*@param iNbMisses will be filled with the number of misses.
+*/
+void gldi_text_cache_get_stats (guint *iNbHits, guint *iNbMisses);
+
+G_END_DECLS
+#endif
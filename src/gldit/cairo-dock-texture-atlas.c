@@ -0,0 +1,303 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <GL/gl.h>
+
+#include "cairo-dock-log.h"
+#include "cairo-dock-draw-opengl.h"  // _cairo_dock_enable_texture
+#include "cairo-dock-image-buffer.h"
+#include "cairo-dock-texture-atlas.h"
+
+#define GLDI_TEXTURE_ATLAS_DEFAULT_SIZE 1024
+#define GLDI_TEXTURE_ATLAS_PADDING 1  // transparent gap between 2 images, so that they don't bleed on each other with linear filtering.
+
+typedef struct {
+	gint y;  // top of the shelf
+	gint iHeight;  // height of the shelf
+	gint x;  // left of the free space on the shelf
+	} GldiAtlasShelf;
+
+typedef struct {
+	GldiTextureAtlasLocation location;
+	GLuint iTexture;  // texture of the image when it was packed; if it differs, the entry belongs to an image that has been freed without being removed, and whose address has been reused.
+	} GldiAtlasEntry;
+
+extern gboolean g_bUseOpenGL;
+
+static GldiTextureAtlas *s_pDefaultAtlas = NULL;
+static GLuint s_iBoundAtlasTexture = 0;  // atlas texture that we bound last, 0 if another texture may have been bound since then.
+static GHashTable *s_hImageLocations = NULL;  // image -> its location in an atlas; kept here rather than in the ImageBuffer, so that its structure doesn't change.
+static const CairoDockImageBuffer *s_pLastImage = NULL;  // last image looked up, since an image is often bound and then drawn.
+static GLuint s_iLastTexture = 0;
+static const GldiTextureAtlasLocation *s_pLastLocation = NULL;
+
+static void _forget_image (const CairoDockImageBuffer *pImage)
+{
+	if (s_hImageLocations != NULL)
+		g_hash_table_remove (s_hImageLocations, pImage);
+	if (s_pLastImage == pImage)
+	{
+		s_pLastImage = NULL;
+		s_pLastLocation = NULL;
+	}
+}
+
+
+static void _clear_atlas (GldiTextureAtlas *pAtlas)
+{
+	guchar *pBlank = g_malloc0 (pAtlas->iSize * pAtlas->iSize * 4);
+	glBindTexture (GL_TEXTURE_2D, pAtlas->iTexture);
+	glTexImage2D (GL_TEXTURE_2D,
+		0,
+		4,
+		pAtlas->iSize,
+		pAtlas->iSize,
+		0,
+		GL_BGRA,
+		GL_UNSIGNED_BYTE,
+		pBlank);
+	g_free (pBlank);
+}
+
+GldiTextureAtlas *gldi_texture_atlas_new (gint iSize)
+{
+	GldiTextureAtlas *pAtlas = g_new0 (GldiTextureAtlas, 1);
+	pAtlas->iSize = iSize;
+	pAtlas->pShelves = g_array_new (FALSE, FALSE, sizeof (GldiAtlasShelf));
+	
+	_cairo_dock_enable_texture ();
+	glGenTextures (1, &pAtlas->iTexture);
+	glBindTexture (GL_TEXTURE_2D, pAtlas->iTexture);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	_clear_atlas (pAtlas);
+	_cairo_dock_disable_texture ();
+	s_iBoundAtlasTexture = 0;
+	return pAtlas;
+}
+
+void gldi_texture_atlas_free (GldiTextureAtlas *pAtlas)
+{
+	if (pAtlas == NULL)
+		return;
+	GList *im;
+	for (im = pAtlas->pImages; im != NULL; im = im->next)  // the images will just use their own texture.
+	{
+		_forget_image (im->data);
+	}
+	g_list_free (pAtlas->pImages);
+	if (pAtlas == s_pDefaultAtlas)
+		s_pDefaultAtlas = NULL;
+	if (s_iBoundAtlasTexture == pAtlas->iTexture)  // its name can be given to a new texture.
+		s_iBoundAtlasTexture = 0;
+	_cairo_dock_delete_texture (pAtlas->iTexture);
+	g_array_free (pAtlas->pShelves, TRUE);
+	g_free (pAtlas);
+}
+
+GldiTextureAtlas *gldi_texture_atlas_get_default (void)
+{
+	if (s_pDefaultAtlas == NULL && g_bUseOpenGL)
+		s_pDefaultAtlas = gldi_texture_atlas_new (GLDI_TEXTURE_ATLAS_DEFAULT_SIZE);
+	return s_pDefaultAtlas;
+}
+
+
+static gboolean _find_space (GldiTextureAtlas *pAtlas, gint w, gint h, gint *x, gint *y)
+{
+	// take the lowest shelf that can hold the image, so that we don't waste too much space.
+	GldiAtlasShelf *pBestShelf = NULL;
+	guint i;
+	for (i = 0; i < pAtlas->pShelves->len; i ++)
+	{
+		GldiAtlasShelf *pShelf = &g_array_index (pAtlas->pShelves, GldiAtlasShelf, i);
+		if (pShelf->iHeight >= h && pShelf->x + w <= pAtlas->iSize
+		&& (pBestShelf == NULL || pShelf->iHeight < pBestShelf->iHeight))
+			pBestShelf = pShelf;
+	}
+	
+	// if there is none or it's much higher than the image, open a new shelf.
+	if ((pBestShelf == NULL || pBestShelf->iHeight > h * 3 / 2) && pAtlas->iNextShelfY + h <= pAtlas->iSize)
+	{
+		GldiAtlasShelf shelf = {pAtlas->iNextShelfY, h, 0};
+		g_array_append_val (pAtlas->pShelves, shelf);
+		pAtlas->iNextShelfY += h;
+		pBestShelf = &g_array_index (pAtlas->pShelves, GldiAtlasShelf, pAtlas->pShelves->len - 1);
+	}
+	if (pBestShelf == NULL)
+		return FALSE;
+	
+	*x = pBestShelf->x;
+	*y = pBestShelf->y;
+	pBestShelf->x += w;
+	return TRUE;
+}
+
+static void _upload_image (GldiTextureAtlas *pAtlas, CairoDockImageBuffer *pImage, int x, int y, int w, int h)
+{
+	cairo_surface_flush (pImage->pSurface);
+	glPixelStorei (GL_UNPACK_ROW_LENGTH, cairo_image_surface_get_stride (pImage->pSurface) / 4);
+	glTexSubImage2D (GL_TEXTURE_2D,
+		0,
+		x,
+		y,
+		w,
+		h,
+		GL_BGRA,
+		GL_UNSIGNED_BYTE,
+		cairo_image_surface_get_data (pImage->pSurface));
+	glPixelStorei (GL_UNPACK_ROW_LENGTH, 0);
+	
+	if (s_hImageLocations == NULL)
+		s_hImageLocations = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+	GldiAtlasEntry *pEntry = g_hash_table_lookup (s_hImageLocations, pImage);
+	if (pEntry == NULL)
+	{
+		pEntry = g_new (GldiAtlasEntry, 1);
+		g_hash_table_insert (s_hImageLocations, pImage, pEntry);
+	}
+	pEntry->iTexture = pImage->iTexture;
+	pEntry->location.pAtlas = pAtlas;
+	pEntry->location.u = (double) x / pAtlas->iSize;
+	pEntry->location.v = (double) y / pAtlas->iSize;
+	pEntry->location.du = (double) w / pAtlas->iSize;
+	pEntry->location.dv = (double) h / pAtlas->iSize;
+	if (s_pLastImage == pImage)
+		s_pLastImage = NULL;
+}
+
+static void _repack_atlas (GldiTextureAtlas *pAtlas)
+{
+	// the space of the removed images is lost until the atlas is repacked; do it from scratch, in the same order.
+	g_array_set_size (pAtlas->pShelves, 0);
+	pAtlas->iNextShelfY = 0;
+	_clear_atlas (pAtlas);
+	
+	GList *pImages = pAtlas->pImages, *im;
+	pAtlas->pImages = NULL;
+	for (im = pImages; im != NULL; im = im->next)
+	{
+		CairoDockImageBuffer *pImage = im->data;
+		if (pImage->pSurface == NULL)  // the surface has been taken from the image, we can't copy it again.
+		{
+			_forget_image (pImage);
+			continue;
+		}
+		int w = cairo_image_surface_get_width (pImage->pSurface);
+		int h = cairo_image_surface_get_height (pImage->pSurface);
+		int x, y;
+		if (_find_space (pAtlas, w + GLDI_TEXTURE_ATLAS_PADDING, h + GLDI_TEXTURE_ATLAS_PADDING, &x, &y))
+		{
+			_upload_image (pAtlas, pImage, x, y, w, h);
+			pAtlas->pImages = g_list_prepend (pAtlas->pImages, pImage);
+		}
+		else  // can't happen since the images fitted before, but just in case.
+		{
+			_forget_image (pImage);
+		}
+	}
+	pAtlas->pImages = g_list_reverse (pAtlas->pImages);
+	pAtlas->iNbRemoved = 0;
+	g_list_free (pImages);
+}
+
+gboolean gldi_texture_atlas_add_image (GldiTextureAtlas *pAtlas, CairoDockImageBuffer *pImage)
+{
+	g_return_val_if_fail (pAtlas != NULL && pImage != NULL, FALSE);
+	gldi_texture_atlas_remove_image (pImage);  // if it's already packed, just refresh it.
+	if (pImage->pSurface == NULL || pImage->iTexture == 0
+	|| cairo_surface_get_type (pImage->pSurface) != CAIRO_SURFACE_TYPE_IMAGE)
+		return FALSE;
+	
+	int w = cairo_image_surface_get_width (pImage->pSurface);
+	int h = cairo_image_surface_get_height (pImage->pSurface);
+	if (w <= 0 || h <= 0 || w > pAtlas->iSize / 4 || h > pAtlas->iSize / 4)  // big images would fill the atlas too quickly, and don't benefit much from it.
+		return FALSE;
+	
+	_cairo_dock_enable_texture ();
+	glBindTexture (GL_TEXTURE_2D, pAtlas->iTexture);
+	
+	//\_______________ find a place, repacking the atlas if some space can be recovered.
+	int x, y;
+	gboolean bFound = _find_space (pAtlas, w + GLDI_TEXTURE_ATLAS_PADDING, h + GLDI_TEXTURE_ATLAS_PADDING, &x, &y);
+	if (! bFound && pAtlas->iNbRemoved != 0)
+	{
+		_repack_atlas (pAtlas);
+		bFound = _find_space (pAtlas, w + GLDI_TEXTURE_ATLAS_PADDING, h + GLDI_TEXTURE_ATLAS_PADDING, &x, &y);
+	}
+	
+	//\_______________ copy the image into it.
+	if (bFound)
+	{
+		_upload_image (pAtlas, pImage, x, y, w, h);
+		pAtlas->pImages = g_list_append (pAtlas->pImages, pImage);
+	}
+	_cairo_dock_disable_texture ();
+	s_iBoundAtlasTexture = 0;  // the images are uploaded from their own texture.
+	return bFound;
+}
+
+const GldiTextureAtlasLocation *gldi_texture_atlas_get_image_location (const CairoDockImageBuffer *pImage)
+{
+	if (pImage != s_pLastImage || pImage->iTexture != s_iLastTexture)
+	{
+		GldiAtlasEntry *pEntry = (s_hImageLocations != NULL ? g_hash_table_lookup (s_hImageLocations, pImage) : NULL);
+		s_pLastImage = pImage;
+		s_iLastTexture = pImage->iTexture;
+		s_pLastLocation = (pEntry != NULL && pEntry->iTexture == pImage->iTexture ? &pEntry->location : NULL);
+	}
+	return s_pLastLocation;
+}
+
+void gldi_texture_atlas_remove_image (CairoDockImageBuffer *pImage)
+{
+	GldiAtlasEntry *pEntry = (s_hImageLocations != NULL ? g_hash_table_lookup (s_hImageLocations, pImage) : NULL);  // even an outdated entry, so that it doesn't stay in the atlas.
+	if (pEntry == NULL)
+		return;
+	GldiTextureAtlas *pAtlas = pEntry->location.pAtlas;
+	_forget_image (pImage);
+	pAtlas->pImages = g_list_remove (pAtlas->pImages, pImage);
+	pAtlas->iNbRemoved ++;  // its space is lost until the atlas is repacked.
+}
+
+
+void gldi_texture_atlas_bind_image (const CairoDockImageBuffer *pImage)
+{
+	const GldiTextureAtlasLocation *pLocation = gldi_texture_atlas_get_image_location (pImage);
+	if (pLocation != NULL)
+	{
+		if (s_iBoundAtlasTexture != pLocation->pAtlas->iTexture)  // don't query the GL state, it would stall the pipeline.
+		{
+			glBindTexture (GL_TEXTURE_2D, pLocation->pAtlas->iTexture);
+			s_iBoundAtlasTexture = pLocation->pAtlas->iTexture;
+		}
+	}
+	else
+	{
+		glBindTexture (GL_TEXTURE_2D, pImage->iTexture);
+		s_iBoundAtlasTexture = 0;
+	}
+}
+
+void gldi_texture_atlas_reset_binding (void)
+{
+	s_iBoundAtlasTexture = 0;
+}
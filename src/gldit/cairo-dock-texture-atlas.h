@@ -0,0 +1,104 @@
+/*
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __CAIRO_DOCK_TEXTURE_ATLAS__
+#define  __CAIRO_DOCK_TEXTURE_ATLAS__
+
+#include <glib.h>
+
+#include "cairo-dock-struct.h"
+G_BEGIN_DECLS
+
+/**
+*@file cairo-dock-texture-atlas.h This class packs many small images into one big texture, so that drawing them doesn't require to bind a different texture each time (for instance when drawing all the icons of a dock).
+* An image packed into an atlas keeps its own texture, that can still be used directly or drawn into; the atlas only holds a copy of it. Therefore, as soon as the image is modified, it's removed from the atlas.
+* The location of an image in its atlas is kept by this class, and can be retrieved with \ref gldi_texture_atlas_get_image_location.
+* The ImageBuffer API (\ref cairo_dock_apply_image_buffer_texture and others) uses the atlas transparently.
+*/
+
+/// Definition of a texture atlas.
+struct _GldiTextureAtlas {
+	/// the texture that holds all the images.
+	GLuint iTexture;
+	/// size of the texture (it's a square).
+	gint iSize;
+	/// shelves where the images are packed: rows of images of similar height.
+	GArray *pShelves;
+	/// ordinate of the next shelf.
+	gint iNextShelfY;
+	/// images currently packed.
+	GList *pImages;
+	/// number of images removed since the last packing, whose space is lost.
+	gint iNbRemoved;
+	} ;
+
+/// Location of an ImageBuffer packed into an atlas.
+typedef struct {
+	/// the atlas.
+	GldiTextureAtlas *pAtlas;
+	/// texture coordinates of the image in the atlas (left, top, width, height).
+	gfloat u, v, du, dv;
+	} GldiTextureAtlasLocation;
+
+/** Create an empty atlas. An OpenGL context must be current.
+*@param iSize size of the atlas texture (it will be iSize x iSize).
+*@return the new atlas, to be freed with \ref gldi_texture_atlas_free.
+*/
+GldiTextureAtlas *gldi_texture_atlas_new (gint iSize);
+
+/** Destroy an atlas. The images it contains are removed from it, and will use their own texture.
+*@param pAtlas the atlas.
+*/
+void gldi_texture_atlas_free (GldiTextureAtlas *pAtlas);
+
+/** Get the atlas shared by all the images of the dock; it's created the first time.
+*@return the atlas, or NULL if OpenGL is not used.
+*/
+GldiTextureAtlas *gldi_texture_atlas_get_default (void);
+
+/** Copy an ImageBuffer into an atlas. The image must have a surface and a texture, and not be too big.
+*@param pAtlas the atlas.
+*@param pImage the image.
+*@return TRUE if the image has been packed into the atlas.
+*/
+gboolean gldi_texture_atlas_add_image (GldiTextureAtlas *pAtlas, CairoDockImageBuffer *pImage);
+
+/** Get the location of an ImageBuffer in its atlas.
+*@param pImage the image.
+*@return the location, or NULL if the image is not packed into an atlas. It stays valid until the image is removed from the atlas.
+*/
+const GldiTextureAtlasLocation *gldi_texture_atlas_get_image_location (const CairoDockImageBuffer *pImage);
+
+/** Remove an ImageBuffer from its atlas, if it's in one. Call it each time the texture of the image is modified.
+*@param pImage the image.
+*/
+void gldi_texture_atlas_remove_image (CairoDockImageBuffer *pImage);
+
+/** Bind the texture that should be used to draw an ImageBuffer: either its atlas, or its own texture. Binding the atlas is skipped if it was the last texture bound through this function, so that drawing several images of the same atlas in a row only binds it once.
+*@param pImage the image.
+*/
+void gldi_texture_atlas_bind_image (const CairoDockImageBuffer *pImage);
+
+/** Forget which atlas is bound, so that the next image of an atlas binds it again. It's done when the current GL context changes and after the icons are rendered by the notifications; call it if you bind a texture yourself before drawing an ImageBuffer.
+*/
+void gldi_texture_atlas_reset_binding (void);
+
+G_END_DECLS
+#endif
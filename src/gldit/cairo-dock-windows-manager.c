@@ -33,6 +33,22 @@ static gboolean s_bSortedByZ = FALSE;  // whether the list is currently sorted b
 static gboolean s_bSortedByAge = FALSE;  // whether the list is currently sorted by age
 static GldiWindowManagerBackend s_backend;
 
+#define GLDI_WINDOWS_GRID_CELL_SIZE 256  // in pixels; a dock only covers a few cells.
+
+typedef struct {
+	GldiWindowActor *actor;
+	gboolean bIndexed;  // whether the window is currently in the grid.
+	gint x0, y0, x1, y1;  // range of cells covered by the window, bounds included.
+	guint iQueryStamp;  // last query that has seen the window, so that it's tested only once.
+	} GldiWindowCells;
+
+static GSList **s_pGridCells = NULL;  // for each cell of the screen, the windows that intersect it.
+static gint s_iGridNbColumns = 0, s_iGridNbRows = 0;
+static gint s_iGridScreenWidth = 0, s_iGridScreenHeight = 0;  // size of the screen the grid has been built for.
+static GHashTable *s_hWindowCells = NULL;  // actor -> GldiWindowCells
+static guint s_iQueryStamp = 0;
+static gboolean s_bGeometryIndexed = FALSE;  // TRUE once the backend sets the geometries through gldi_window_set_geometry; until then the grid can't be trusted.
+
 
 static gboolean on_zorder_changed (G_GNUC_UNUSED gpointer data)
 {
@@ -91,6 +107,150 @@ GldiWindowActor *gldi_windows_find (gboolean (*callback) (GldiWindowActor*, gpoi
 }
 
 
+  /////////////////
+ /// AREA GRID ///
+/////////////////
+
+static gboolean _get_cells_range (GtkAllocation *pArea, gint *x0, gint *y0, gint *x1, gint *y1)
+{
+	if (pArea->width <= 0 || pArea->height <= 0
+	|| pArea->x + pArea->width <= 0 || pArea->x >= s_iGridScreenWidth
+	|| pArea->y + pArea->height <= 0 || pArea->y >= s_iGridScreenHeight)  // outside of the screen
+		return FALSE;
+	*x0 = MAX (0, pArea->x) / GLDI_WINDOWS_GRID_CELL_SIZE;
+	*y0 = MAX (0, pArea->y) / GLDI_WINDOWS_GRID_CELL_SIZE;
+	*x1 = (MIN (s_iGridScreenWidth, pArea->x + pArea->width) - 1) / GLDI_WINDOWS_GRID_CELL_SIZE;
+	*y1 = (MIN (s_iGridScreenHeight, pArea->y + pArea->height) - 1) / GLDI_WINDOWS_GRID_CELL_SIZE;
+	return TRUE;
+}
+
+static void _grid_remove_window (GldiWindowCells *pCells)
+{
+	if (! pCells->bIndexed)
+		return;
+	int x, y;
+	for (y = pCells->y0; y <= pCells->y1; y ++)
+	{
+		for (x = pCells->x0; x <= pCells->x1; x ++)
+		{
+			GSList **pCell = &s_pGridCells[y * s_iGridNbColumns + x];
+			*pCell = g_slist_remove (*pCell, pCells);
+		}
+	}
+	pCells->bIndexed = FALSE;
+}
+
+static void _grid_add_window (GldiWindowCells *pCells)
+{
+	if (! _get_cells_range (&pCells->actor->windowGeometry, &pCells->x0, &pCells->y0, &pCells->x1, &pCells->y1))
+		return;
+	int x, y;
+	for (y = pCells->y0; y <= pCells->y1; y ++)
+	{
+		for (x = pCells->x0; x <= pCells->x1; x ++)
+		{
+			GSList **pCell = &s_pGridCells[y * s_iGridNbColumns + x];
+			*pCell = g_slist_prepend (*pCell, pCells);
+		}
+	}
+	pCells->bIndexed = TRUE;
+}
+
+static gboolean _grid_is_valid (void)
+{
+	return (s_pGridCells != NULL && s_iGridScreenWidth == gldi_desktop_get_width() && s_iGridScreenHeight == gldi_desktop_get_height());
+}
+
+static void _grid_free (void)
+{
+	if (s_pGridCells == NULL)
+		return;
+	int i;
+	for (i = 0; i < s_iGridNbColumns * s_iGridNbRows; i ++)
+		g_slist_free (s_pGridCells[i]);
+	g_free (s_pGridCells);
+	s_pGridCells = NULL;
+	if (s_hWindowCells != NULL)
+	{
+		GHashTableIter iter;
+		gpointer value;
+		g_hash_table_iter_init (&iter, s_hWindowCells);
+		while (g_hash_table_iter_next (&iter, NULL, &value))
+			((GldiWindowCells*)value)->bIndexed = FALSE;
+	}
+}
+
+static void _grid_build (void)  // built on demand, and rebuilt when the size of the screen changes.
+{
+	_grid_free ();
+	s_iGridScreenWidth = gldi_desktop_get_width();
+	s_iGridScreenHeight = gldi_desktop_get_height();
+	if (s_iGridScreenWidth <= 0 || s_iGridScreenHeight <= 0)
+		return;
+	s_iGridNbColumns = (s_iGridScreenWidth + GLDI_WINDOWS_GRID_CELL_SIZE - 1) / GLDI_WINDOWS_GRID_CELL_SIZE;
+	s_iGridNbRows = (s_iGridScreenHeight + GLDI_WINDOWS_GRID_CELL_SIZE - 1) / GLDI_WINDOWS_GRID_CELL_SIZE;
+	s_pGridCells = g_new0 (GSList*, s_iGridNbColumns * s_iGridNbRows);
+	
+	GList *a;
+	for (a = s_pWindowsList; a != NULL; a = a->next)
+	{
+		GldiWindowCells *pCells = g_hash_table_lookup (s_hWindowCells, a->data);
+		if (pCells != NULL)
+			_grid_add_window (pCells);
+	}
+}
+
+GldiWindowActor *gldi_windows_find_in_area (GtkAllocation *pArea, gboolean (*callback) (GldiWindowActor*, gpointer), gpointer data)
+{
+	g_return_val_if_fail (pArea != NULL, NULL);
+	if (! s_bGeometryIndexed)  // the backend writes the geometries directly, so the grid would be outdated -> test all the windows.
+		return gldi_windows_find (callback, data);
+	if (! _grid_is_valid ())
+		_grid_build ();
+	int x0, y0, x1, y1;
+	if (s_pGridCells == NULL || ! _get_cells_range (pArea, &x0, &y0, &x1, &y1))
+		return NULL;
+	
+	s_iQueryStamp ++;
+	GldiWindowCells *pCells;
+	GSList *c;
+	int x, y;
+	for (y = y0; y <= y1; y ++)
+	{
+		for (x = x0; x <= x1; x ++)
+		{
+			for (c = s_pGridCells[y * s_iGridNbColumns + x]; c != NULL; c = c->next)
+			{
+				pCells = c->data;
+				if (pCells->iQueryStamp == s_iQueryStamp)  // already seen in another cell.
+					continue;
+				pCells->iQueryStamp = s_iQueryStamp;
+				if (callback (pCells->actor, data))
+					return pCells->actor;
+			}
+		}
+	}
+	return NULL;
+}
+
+void gldi_window_set_geometry (GldiWindowActor *actor, int x, int y, int w, int h)
+{
+	g_return_if_fail (actor != NULL);
+	s_bGeometryIndexed = TRUE;
+	actor->windowGeometry.x = x;
+	actor->windowGeometry.y = y;
+	actor->windowGeometry.width = w;
+	actor->windowGeometry.height = h;
+	
+	GldiWindowCells *pCells = g_hash_table_lookup (s_hWindowCells, actor);
+	if (pCells != NULL && _grid_is_valid ())  // else it will be built with the new geometry at the next query.
+	{
+		_grid_remove_window (pCells);
+		_grid_add_window (pCells);
+	}
+}
+
+
   ///////////////
  /// BACKEND ///
 ///////////////
@@ -211,6 +371,19 @@ cairo_surface_t *gldi_window_get_icon_surface (GldiWindowActor *actor, int iWidt
 	return NULL;
 }
 
+cairo_surface_t *gldi_window_get_icon_surface_threaded (GldiWindowActor *actor, int iWidth, int iHeight)
+{
+	g_return_val_if_fail (actor != NULL, NULL);
+	if (s_backend.get_icon_surface_threaded)
+		return s_backend.get_icon_surface_threaded (actor, iWidth, iHeight);
+	return NULL;
+}
+
+gboolean gldi_window_can_get_icon_surface_threaded (void)
+{
+	return (s_backend.get_icon_surface_threaded != NULL);
+}
+
 cairo_surface_t *gldi_window_get_thumbnail_surface (GldiWindowActor *actor, int iWidth, int iHeight)
 {
 	g_return_val_if_fail (actor != NULL, NULL);
@@ -349,6 +522,10 @@ static void init_object (GldiObject *obj, G_GNUC_UNUSED gpointer attr)
 {
 	GldiWindowActor *actor = (GldiWindowActor*)obj;
 	s_pWindowsList = g_list_prepend (s_pWindowsList, actor);
+	
+	GldiWindowCells *pCells = g_new0 (GldiWindowCells, 1);  // the window is put in the grid once its geometry is known.
+	pCells->actor = actor;
+	g_hash_table_insert (s_hWindowCells, actor, pCells);
 }
 
 static void reset_object (GldiObject *obj)
@@ -359,6 +536,13 @@ static void reset_object (GldiObject *obj)
 	g_free (actor->cWmClass);
 	g_free (actor->cLastAttentionDemand);
 	s_pWindowsList = g_list_remove (s_pWindowsList, actor);
+	
+	GldiWindowCells *pCells = g_hash_table_lookup (s_hWindowCells, actor);
+	if (pCells != NULL)
+	{
+		_grid_remove_window (pCells);
+		g_hash_table_remove (s_hWindowCells, actor);  // frees pCells
+	}
 }
 
 void gldi_register_windows_manager (void)
@@ -375,6 +559,7 @@ void gldi_register_windows_manager (void)
 	
 	// init
 	memset (&s_backend, 0, sizeof (GldiWindowManagerBackend));
+	s_hWindowCells = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
 	gldi_object_register_notification (&myWindowObjectMgr,
 		NOTIFICATION_WINDOW_Z_ORDER_CHANGED,
 		(GldiNotificationFunc) on_zorder_changed,
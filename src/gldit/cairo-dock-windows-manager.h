@@ -78,6 +78,7 @@ struct _GldiWindowManagerBackend {
 	void (*can_minimize_maximize_close) (GldiWindowActor *actor, gboolean *bCanMinimize, gboolean *bCanMaximize, gboolean *bCanClose);
 	guint (*get_id) (GldiWindowActor *actor);
 	GldiWindowActor* (*pick_window) (void);  // grab the mouse, wait for a click, then get the clicked window and returns its actor
+	cairo_surface_t* (*get_icon_surface_threaded) (GldiWindowActor *actor, int iWidth, int iHeight);  // same as get_icon_surface, but can be called from any thread; it may return NULL if the icon can only be got from the main thread.
 	} ;
 
 /// Definition of a window actor.
@@ -120,12 +121,29 @@ void gldi_windows_foreach (gboolean bOrderedByZ, GFunc callback, gpointer data);
 */
 GldiWindowActor *gldi_windows_find (gboolean (*callback) (GldiWindowActor*, gpointer), gpointer data);
 
+/** Run a function on the window actors that may intersect an area of the screen, until it returns TRUE. The windows are taken from a grid that indexes them by position, so only a few of them are tested; the callback still has to check the exact geometry of the windows (and their desktop and state). If the backend doesn't use \ref gldi_window_set_geometry, all the windows are tested, like \ref gldi_windows_find.
+*@param pArea an area, in the referential of the screen
+*@param callback the callback (takes the actor and the data, returns TRUE to stop)
+*@param data user data
+*@return the found actor, or NULL
+*/
+GldiWindowActor *gldi_windows_find_in_area (GtkAllocation *pArea, gboolean (*callback) (GldiWindowActor*, gpointer), gpointer data);
+
 /** Get the current active window actor.
 *@return the actor, or NULL if no window is currently active
 */
 GldiWindowActor* gldi_windows_get_active (void);
 
 
+/** Set the geometry of a window actor; backends should use it rather than setting windowGeometry directly, so that the window is indexed by \ref gldi_windows_find_in_area. Once a backend uses it, it must use it for every change of geometry.
+*@param actor the actor
+*@param x position of the window, in the referential of the current viewport
+*@param y position of the window, in the referential of the current viewport
+*@param w width of the window
+*@param h height of the window
+*/
+void gldi_window_set_geometry (GldiWindowActor *actor, int x, int y, int w, int h);
+
 void gldi_window_move_to_desktop (GldiWindowActor *actor, int iNumDesktop, int iNumViewportX, int iNumViewportY);
 
 void gldi_window_show (GldiWindowActor *actor);
@@ -145,6 +163,15 @@ void gldi_window_set_border (GldiWindowActor *actor, gboolean bWithBorder);
 
 cairo_surface_t* gldi_window_get_icon_surface (GldiWindowActor *actor, int iWidth, int iHeight);
 
+/** Get the icon of a window from a thread. The actor must stay alive during the call (keep a reference on it).
+*@return an image surface, or NULL if the icon couldn't be got this way; in this case, use \ref gldi_window_get_icon_surface in the main thread.
+*/
+cairo_surface_t* gldi_window_get_icon_surface_threaded (GldiWindowActor *actor, int iWidth, int iHeight);
+
+/** Tell if the backend can get the icon of a window outside of the main thread.
+*/
+gboolean gldi_window_can_get_icon_surface_threaded (void);
+
 cairo_surface_t* gldi_window_get_thumbnail_surface (GldiWindowActor *actor, int iWidth, int iHeight);
 
 GLuint gldi_window_get_texture (GldiWindowActor *actor);
@@ -86,6 +86,10 @@ static Atom s_aNetStartupInfoBegin;
 static Atom s_aNetStartupInfo;
 static GHashTable *s_hXWindowTable = NULL;  // table of (Xid,actor)
 static GHashTable *s_hXClientMessageTable = NULL;  // table of (Xid,client-message)
+static Window *s_pLastXWindowsList = NULL;  // stacking list of the previous update, to only look at what has changed since then
+static gulong s_iNbLastXWindows = 0;
+static GArray *s_pXEventsBatch = NULL;  // events read in one dispatch
+static GHashTable *s_hXEventsKeys = NULL;  // set of (Xid,type,atom) already seen in the batch
 static int s_iTime = 1;  // on peut aller jusqu'a 2^31, soit 17 ans a 4Hz.
 static int s_iNumWindow = 1;  // used to order appli icons by age (=creation date).
 static Window s_iCurrentActiveWindow = 0;
@@ -154,7 +158,7 @@ static GldiXWindowActor *_make_new_actor (Window Xid)
 	}
 	else
 	{
-		XGetTransientForHint (s_XDisplay, Xid, &iTransientFor);
+		iTransientFor = cairo_dock_get_xwindow_transient_for (Xid);
 	}
 	
 	//\__________________ if the window passed all the tests, make a new actor
@@ -260,21 +264,17 @@ static void _update_backing_pixmap (GldiXWindowActor *actor)
 #endif
 }
 
-static gboolean _remove_old_applis (Window *Xid, GldiXWindowActor *actor, gpointer iTimePtr)
+static void _remove_old_appli (GldiXWindowActor *actor)
 {
-	gint iTime = GPOINTER_TO_INT (iTimePtr);
-	if (actor->iLastCheckTime >= 0 && actor->iLastCheckTime < iTime)
-	{
-		cd_message ("cette fenetre (%ld, %p, %s) est trop vieille (%d / %d)", *Xid, actor, actor->actor.cName, actor->iLastCheckTime, iTime);
-		// notify everybody
-		if (! actor->bIgnored)
-			gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_DESTROYED, actor);
-		
-		actor->iLastCheckTime = -1;  // to not remove it from the table during the free
-		_delete_actor (actor);
-		return TRUE;  // remove it from the table
-	}
-	return FALSE;
+	cd_message ("cette fenetre (%ld, %p, %s) est trop vieille (%d / %d)", actor->Xid, actor, actor->actor.cName, actor->iLastCheckTime, s_iTime);
+	// notify everybody
+	if (! actor->bIgnored)
+		gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_DESTROYED, actor);
+	
+	// remove it from the table
+	g_hash_table_remove (s_hXWindowTable, &actor->Xid);
+	actor->iLastCheckTime = -1;  // to not remove it from the table again during the free
+	_delete_actor (actor);
 }
 static void _on_update_applis_list (void)
 {
@@ -283,9 +283,22 @@ static void _on_update_applis_list (void)
 	gulong i, iNbWindows = 0;
 	Window *pXWindowsList = cairo_dock_get_windows_list (&iNbWindows, TRUE);  // TRUE => ordered by z-stack.
 	
-	// set the z-order of existing windows, and create actors for new windows
+	// get the properties of all the new windows at once (there can be a lot of them at startup or when a session is restored).
 	Window Xid;
 	GldiXWindowActor *actor;
+	Window *pNewXids = g_new (Window, iNbWindows + 1);
+	gulong iNbNewWindows = 0;
+	for (i = 0; i < iNbWindows; i ++)
+	{
+		Xid = pXWindowsList[i];
+		if (g_hash_table_lookup (s_hXWindowTable, &Xid) == NULL)
+			pNewXids[iNbNewWindows ++] = Xid;
+	}
+	cairo_dock_prefetch_xwindows_properties (pNewXids, iNbNewWindows);
+	g_free (pNewXids);
+	
+	// set the z-order of existing windows, and create actors for new windows
+	gboolean bStackChanged = FALSE;
 	int iStackOrder = 0;
 	for (i = 0; i < iNbWindows; i ++)
 	{
@@ -301,23 +314,49 @@ static void _on_update_applis_list (void)
 			
 			// notify everybody
 			if (! actor->bIgnored)
+			{
 				gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_CREATED, actor);
+				bStackChanged = TRUE;
+			}
 		}
 		else  // just update its check-time
 			actor->iLastCheckTime = s_iTime;
 		
 		// update the z-order
 		if (! actor->bIgnored)
-			actor->actor.iStackOrder = iStackOrder ++;
+		{
+			if (actor->actor.iStackOrder != iStackOrder)
+			{
+				actor->actor.iStackOrder = iStackOrder;
+				bStackChanged = TRUE;
+			}
+			iStackOrder ++;
+		}
 	}
+	cairo_dock_clear_prefetched_xwindows_properties ();
 	
-	// remove old actors for windows that disappeared
-	g_hash_table_foreach_remove (s_hXWindowTable, (GHRFunc) _remove_old_applis, GINT_TO_POINTER (s_iTime));
+	// remove old actors for windows that disappeared; they can only be in the previous list, so no need to sweep the whole table.
+	for (i = 0; i < s_iNbLastXWindows; i ++)
+	{
+		Xid = s_pLastXWindowsList[i];
+		actor = g_hash_table_lookup (s_hXWindowTable, &Xid);
+		if (actor != NULL && actor->iLastCheckTime >= 0 && actor->iLastCheckTime < s_iTime)
+		{
+			if (! actor->bIgnored)
+				bStackChanged = TRUE;
+			_remove_old_appli (actor);
+		}
+	}
 	
-	// notify everybody that the stack order has changed
-	gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_Z_ORDER_CHANGED, NULL);
+	// keep the list for the next time
+	if (s_pLastXWindowsList != NULL)
+		XFree (s_pLastXWindowsList);
+	s_pLastXWindowsList = pXWindowsList;
+	s_iNbLastXWindows = iNbWindows;
 	
-	XFree (pXWindowsList);
+	// notify everybody that the stack order has changed, if it did (the list is also updated when a window that we ignore is raised, or when the WM just re-sets it).
+	if (bStackChanged)
+		gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_Z_ORDER_CHANGED, NULL);
 }
 
 static void _set_demand_attention (GldiXWindowActor *actor, XAttentionFlag flag)
@@ -355,6 +394,67 @@ static void lookup_ignorable_modifiers (void)
 	scroll_lock_mask = XkbKeysymToModifiers (s_XDisplay, GDK_KEY_Scroll_Lock);
 }
 
+static inline gboolean _Xevent_can_be_coalesced (XEvent *e)
+{
+	// the handlers of these events re-read the current state of the window (property or geometry), so only the last one of a batch matters; but the state of a property is kept in the key, since some handlers only react to a new value (e.g. WM_HINTS).
+	return (e->type == PropertyNotify
+	|| (e->type == ConfigureNotify && e->xany.window != DefaultRootWindow (s_XDisplay)));
+}
+static guint _Xevent_key_hash (gconstpointer p)
+{
+	const XEvent *e = p;
+	gulong atom = (e->type == PropertyNotify ? e->xproperty.atom * 2 + e->xproperty.state : 0);
+	return (guint) (e->xany.window * 31 + atom) ^ (guint) e->type;
+}
+static gboolean _Xevent_key_equal (gconstpointer a, gconstpointer b)
+{
+	const XEvent *e1 = a, *e2 = b;
+	return (e1->type == e2->type
+		&& e1->xany.window == e2->xany.window
+		&& (e1->type != PropertyNotify || (e1->xproperty.atom == e2->xproperty.atom && e1->xproperty.state == e2->xproperty.state)));
+}
+static int _fetch_and_coalesce_Xevents (int nb_msg)
+{
+	if (s_pXEventsBatch == NULL)
+	{
+		s_pXEventsBatch = g_array_new (FALSE, FALSE, sizeof (XEvent));
+		s_hXEventsKeys = g_hash_table_new (_Xevent_key_hash, _Xevent_key_equal);
+	}
+	
+	//\__________________ pull the whole batch out of the queue.
+	g_array_set_size (s_pXEventsBatch, nb_msg);
+	XEvent *pEvents = (XEvent*) s_pXEventsBatch->data;
+	int i, n;
+	for (i = 0; i < nb_msg; i ++)
+		XNextEvent (s_XDisplay, &pEvents[i]);
+	
+	//\__________________ walk it backwards: an event whose (window, type, atom, state) shows up later in the batch is superseded.
+	gboolean *bSuperseded = g_new0 (gboolean, nb_msg);
+	for (i = nb_msg - 1; i >= 0; i --)
+	{
+		if (! _Xevent_can_be_coalesced (&pEvents[i]))
+			continue;
+		if (g_hash_table_lookup (s_hXEventsKeys, &pEvents[i]) != NULL)
+			bSuperseded[i] = TRUE;
+		else
+			g_hash_table_insert (s_hXEventsKeys, &pEvents[i], &pEvents[i]);
+	}
+	g_hash_table_remove_all (s_hXEventsKeys);  // keys point into the array, don't keep them
+	
+	//\__________________ compact the batch, keeping the order of the remaining events.
+	for (i = 0, n = 0; i < nb_msg; i ++)
+	{
+		if (bSuperseded[i])
+			continue;
+		if (n != i)
+			pEvents[n] = pEvents[i];
+		n ++;
+	}
+	g_free (bSuperseded);
+	//if (n != nb_msg) g_print ("%d X msg coalesced into %d\n", nb_msg, n);
+	return n;
+}
+
 static gboolean _cairo_dock_unstack_Xevents (G_GNUC_UNUSED gpointer data)
 {
 	static XEvent event;
@@ -369,10 +469,13 @@ static gboolean _cairo_dock_unstack_Xevents (G_GNUC_UNUSED gpointer data)
 	int i, nb_msg = XEventsQueued (s_XDisplay, QueuedAfterReading);
 	//g_print ("%d X msg\n", nb_msg);
 	
+	// take them all at once, so that a storm of notifications on the same property (name, icon, client list, etc) is handled only once.
+	nb_msg = _fetch_and_coalesce_Xevents (nb_msg);
+	
 	for (i = 0; i < nb_msg; i ++)
 	{
-		// get the next event in the queue
-		XNextEvent (s_XDisplay, &event);
+		// get the next event of the batch
+		event = g_array_index (s_pXEventsBatch, XEvent, i);
 		Xid = event.xany.window;
 		//g_print (" %d) type : %d; atom : %s; window : %d\n", i, event.type, XGetAtomName (s_XDisplay, event.xproperty.atom), Xid);
 		
@@ -690,10 +793,7 @@ static gboolean _cairo_dock_unstack_Xevents (G_GNUC_UNUSED gpointer data)
 				int x = event.xconfigure.x, y = event.xconfigure.y;
 				int w = event.xconfigure.width, h = event.xconfigure.height;
 				cairo_dock_get_xwindow_geometry (Xid, &x, &y, &w, &h);
-				actor->windowGeometry.width = w;
-				actor->windowGeometry.height = h;
-				actor->windowGeometry.x = x;
-				actor->windowGeometry.y = y;
+				gldi_window_set_geometry (actor, x, y, w, h);  // also updates the index of windows by position.
 				
 				actor->iViewPortX = x / gldi_desktop_get_width() + g_desktopGeometry.iCurrentViewportX;
 				actor->iViewPortY = y / gldi_desktop_get_height() + g_desktopGeometry.iCurrentViewportY;
@@ -982,6 +1082,12 @@ static cairo_surface_t* _get_icon_surface (GldiWindowActor *actor, int iWidth, i
 	return cairo_dock_create_surface_from_xwindow (xactor->Xid, iWidth, iHeight);
 }
 
+static cairo_surface_t* _get_icon_surface_threaded (GldiWindowActor *actor, int iWidth, int iHeight)
+{
+	GldiXWindowActor *xactor = (GldiXWindowActor *)actor;
+	return cairo_dock_create_surface_from_xwindow_threaded (xactor->Xid, iWidth, iHeight);
+}
+
 static cairo_surface_t* _get_thumbnail_surface (GldiWindowActor *actor, int iWidth, int iHeight)
 {
 	GldiXWindowActor *xactor = (GldiXWindowActor *)actor;
@@ -1190,13 +1296,15 @@ static void init (void)
 	cd_debug ("got %d X windows", iNbWindows);
 	
 	Window Xid;
+	cairo_dock_prefetch_xwindows_properties (pXWindowsList, iNbWindows);
 	for (i = 0; i < iNbWindows; i ++)
 	{
 		Xid = pXWindowsList[i];
 		(void)_make_new_actor (Xid);
 	}
-	if (pXWindowsList != NULL)
-		XFree (pXWindowsList);
+	cairo_dock_clear_prefetched_xwindows_properties ();
+	s_pLastXWindowsList = pXWindowsList;  // keep it for the next update of the list, to know which windows have disappeared.
+	s_iNbLastXWindows = iNbWindows;
 	
 	//\__________________ get the current active window
 	if (s_iCurrentActiveWindow == 0)
@@ -1264,6 +1372,7 @@ static void init (void)
 	wmb.can_minimize_maximize_close = _can_minimize_maximize_close;
 	wmb.get_id = _get_id;
 	wmb.pick_window = _pick_window;
+	wmb.get_icon_surface_threaded = _get_icon_surface_threaded;
 	gldi_windows_manager_register_backend (&wmb);
 	
 	GldiContainerManagerBackend cmb;
@@ -1306,10 +1415,7 @@ static void init_object (GldiObject *obj, gpointer attr)
 	actor->iViewPortX = iLocalPositionX / g_desktopGeometry.Xscreen.width + g_desktopGeometry.iCurrentViewportX;
 	actor->iViewPortY = iLocalPositionY / g_desktopGeometry.Xscreen.height + g_desktopGeometry.iCurrentViewportY;
 	
-	actor->windowGeometry.x = iLocalPositionX;
-	actor->windowGeometry.y = iLocalPositionY;
-	actor->windowGeometry.width = iWidthExtent;
-	actor->windowGeometry.height = iHeightExtent;
+	gldi_window_set_geometry (actor, iLocalPositionX, iLocalPositionY, iWidthExtent, iHeightExtent);
 	
 	actor->iAge = s_iNumWindow ++;
 	
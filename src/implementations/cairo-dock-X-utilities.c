@@ -19,6 +19,8 @@
 
 #include "gldi-config.h"
 #ifdef HAVE_X11
+#include <stdlib.h>  // malloc
+#include <string.h>  // memcpy
 #include <X11/Xlib.h>
 #include <X11/Xatom.h>
 #include <X11/Xutil.h>
@@ -30,11 +32,18 @@
 #include <X11/extensions/Xinerama.h>  // Note: Xinerama is deprecated by XRandr >= 1.3
 #endif
 #include <X11/extensions/Xrandr.h>
+#include <X11/extensions/XShm.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#endif
+#ifdef HAVE_X11_XCB
+#include <X11/Xlib-xcb.h>
+#include <xcb/xcb.h>
 #endif
 
 #include "cairo-dock-log.h"
 #include "cairo-dock-utils.h"  // cairo_dock_remove_version_from_string, cairo_dock_check_xrandr
-#include "cairo-dock-surface-factory.h"  // cairo_dock_create_surface_from_xicon_buffer
+#include "cairo-dock-surface-factory.h"  // cairo_dock_create_surface_from_xicon_pixels
 #include "cairo-dock-desktop-manager.h"
 #include "cairo-dock-opengl.h"  // for texture_from_pixmap
 #include "cairo-dock-X-utilities.h"
@@ -47,6 +56,7 @@ extern CairoDockGLConfig g_openglConfig;
 static gboolean s_bUseXComposite = TRUE;
 static gboolean s_bUseXinerama = TRUE;
 static gboolean s_bUseXrandr = TRUE;
+static gboolean s_bUseXShm = TRUE;
 //extern int g_iDamageEvent;
 
 static Display *s_XDisplay = NULL;
@@ -89,6 +99,22 @@ static Atom s_aUtf8String;
 static Atom s_aString;
 static unsigned char error_code = Success;
 
+// properties fetched in advance for several windows at once (see cairo_dock_prefetch_xwindows_properties).
+typedef struct {
+	Atom aProperty;  // None once it has been used
+	Atom aType;
+	Atom aReturnedType;
+	int iReturnedFormat;
+	gulong iBufferNbElements;
+	guchar *pBuffer;  // same layout as XGetWindowProperty, to be freed with XFree
+	} CDXPrefetchedProperty;
+#define CD_NB_PREFETCHED_PROPERTIES 7
+static GHashTable *s_hPrefetchedProperties = NULL;  // Xid -> CDXPrefetchedProperty[CD_NB_PREFETCHED_PROPERTIES]
+
+// connection used to get the windows' icons from the worker threads. Xlib is not initialized for multi-threading, and its errors go to a global handler that is used by the main thread; so it's a plain XCB connection, which is thread-safe and returns the errors with each reply.
+static xcb_connection_t *s_pWorkerConnection = NULL;
+G_LOCK_DEFINE_STATIC (s_pWorkerConnection);
+
 static GtkAllocation *_get_screens_geometry (int *pNbScreens);
 
 static gboolean cairo_dock_support_X_extension (void);
@@ -111,6 +137,133 @@ static int _cairo_dock_xerror_handler (G_GNUC_UNUSED Display * pDisplay, XErrorE
 	error_code = pXError->error_code;
 	return 0;
 }
+static void _get_xwindow_property (Window Xid, Atom aProperty, Atom aType, Atom *aReturnedType, int *aReturnedFormat, gulong *iBufferNbElements, guchar **pBuffer)
+{
+	// use the property if it has been prefetched
+	if (s_hPrefetchedProperties != NULL)
+	{
+		CDXPrefetchedProperty *pProperties = g_hash_table_lookup (s_hPrefetchedProperties, GSIZE_TO_POINTER (Xid));
+		int i;
+		for (i = 0; pProperties != NULL && i < CD_NB_PREFETCHED_PROPERTIES; i ++)
+		{
+			CDXPrefetchedProperty *p = &pProperties[i];
+			if (p->aProperty == aProperty && p->aType == aType)
+			{
+				*aReturnedType = p->aReturnedType;
+				*aReturnedFormat = p->iReturnedFormat;
+				*iBufferNbElements = p->iBufferNbElements;
+				*pBuffer = p->pBuffer;  // the caller takes it
+				p->pBuffer = NULL;
+				p->aProperty = None;  // can only be used once, next time we'll ask the server.
+				return;
+			}
+		}
+	}
+	// otherwise make a round-trip to the server
+	gulong iLeftBytes;
+	XGetWindowProperty (s_XDisplay, Xid, aProperty, 0, G_MAXULONG, False, aType, aReturnedType, aReturnedFormat, iBufferNbElements, &iLeftBytes, pBuffer);
+}
+
+static void _free_prefetched_properties (CDXPrefetchedProperty *pProperties)
+{
+	int i;
+	for (i = 0; i < CD_NB_PREFETCHED_PROPERTIES; i ++)
+	{
+		if (pProperties[i].pBuffer != NULL)
+			XFree (pProperties[i].pBuffer);
+	}
+	g_free (pProperties);
+}
+
+void cairo_dock_prefetch_xwindows_properties (Window *pXids, gulong iNbWindows)
+{
+	cairo_dock_clear_prefetched_xwindows_properties ();
+	#ifdef HAVE_X11_XCB
+	if (iNbWindows < 2)  // nothing to gain.
+		return;
+	xcb_connection_t *pConnection = XGetXCBConnection (s_XDisplay);
+	
+	// the properties that are read when a new window appears (state, type, class, name, desktop).
+	const Atom aProperties[CD_NB_PREFETCHED_PROPERTIES][2] = {
+		{s_aNetWmState, XA_ATOM},
+		{s_aNetWmWindowType, XA_ATOM},
+		{XA_WM_TRANSIENT_FOR, XA_WINDOW},
+		{XA_WM_CLASS, XA_STRING},
+		{s_aNetWmName, s_aUtf8String},
+		{s_aWmName, s_aString},
+		{s_aNetWmDesktop, XA_CARDINAL}};
+	
+	// send all the requests at once...
+	gulong i;
+	int j;
+	xcb_get_property_cookie_t *pCookies = g_new (xcb_get_property_cookie_t, iNbWindows * CD_NB_PREFETCHED_PROPERTIES);
+	for (i = 0; i < iNbWindows; i ++)
+	{
+		for (j = 0; j < CD_NB_PREFETCHED_PROPERTIES; j ++)
+			pCookies[i * CD_NB_PREFETCHED_PROPERTIES + j] = xcb_get_property (pConnection, 0, pXids[i], aProperties[j][0], aProperties[j][1], 0, G_MAXUINT32 / 4);
+	}
+	
+	// ... then collect the replies, so that we pay the latency of the connection only once.
+	s_hPrefetchedProperties = g_hash_table_new_full (g_direct_hash,
+		g_direct_equal,
+		NULL,
+		(GDestroyNotify)_free_prefetched_properties);
+	for (i = 0; i < iNbWindows; i ++)
+	{
+		CDXPrefetchedProperty *pProperties = g_new0 (CDXPrefetchedProperty, CD_NB_PREFETCHED_PROPERTIES);
+		for (j = 0; j < CD_NB_PREFETCHED_PROPERTIES; j ++)
+		{
+			CDXPrefetchedProperty *p = &pProperties[j];
+			p->aProperty = aProperties[j][0];
+			p->aType = aProperties[j][1];
+			xcb_generic_error_t *pError = NULL;  // the window may have been destroyed in the meantime.
+			xcb_get_property_reply_t *pReply = xcb_get_property_reply (pConnection, pCookies[i * CD_NB_PREFETCHED_PROPERTIES + j], &pError);
+			free (pError);
+			if (pReply == NULL)
+				continue;
+			p->aReturnedType = pReply->type;
+			p->iReturnedFormat = pReply->format;
+			int iLength = xcb_get_property_value_length (pReply);  // in bytes
+			if (pReply->format != 0 && iLength > 0)
+			{
+				p->iBufferNbElements = iLength / (pReply->format / 8);
+				if (pReply->format == 32)  // Xlib returns 32 bits values as longs
+				{
+					long *pBuffer = malloc ((p->iBufferNbElements + 1) * sizeof (long));
+					const uint32_t *pValue = xcb_get_property_value (pReply);
+					gulong k;
+					for (k = 0; k < p->iBufferNbElements; k ++)
+						pBuffer[k] = pValue[k];
+					pBuffer[k] = 0;
+					p->pBuffer = (guchar*)pBuffer;
+				}
+				else  // Xlib always adds a null byte at the end
+				{
+					p->pBuffer = malloc (iLength + 1);
+					memcpy (p->pBuffer, xcb_get_property_value (pReply), iLength);
+					p->pBuffer[iLength] = '\0';
+				}
+			}
+			free (pReply);
+		}
+		g_hash_table_insert (s_hPrefetchedProperties, GSIZE_TO_POINTER (pXids[i]), pProperties);
+	}
+	g_free (pCookies);
+	#else
+	(void)pXids;
+	(void)iNbWindows;
+	#endif
+}
+
+void cairo_dock_clear_prefetched_xwindows_properties (void)
+{
+	if (s_hPrefetchedProperties != NULL)
+	{
+		g_hash_table_destroy (s_hPrefetchedProperties);
+		s_hPrefetchedProperties = NULL;
+	}
+}
+
 Display *cairo_dock_initialize_X_desktop_support (void)
 {
 	if (s_XDisplay != NULL)
@@ -760,12 +913,20 @@ static gboolean cairo_dock_support_X_extension (void)
 	// check for Xrandr >= 1.3
 	s_bUseXrandr = cairo_dock_check_xrandr (1, 3);
 	
+	// check for XShm (only useful with a local X server)
+	if (! XShmQueryExtension (s_XDisplay))
+	{
+		cd_warning ("XShm extension not supported");
+		s_bUseXShm = FALSE;
+	}
+	
 	return TRUE;
 #else
-	cd_warning ("The dock was not compiled with the X extensions (XComposite, Xinerama, Xtest, Xrandr, etc).");
+	cd_warning ("The dock was not compiled with the X extensions (XComposite, Xinerama, Xtest, Xrandr, XShm, etc).");
 	s_bUseXComposite = FALSE;
 	s_bUseXinerama = FALSE;
 	s_bUseXrandr = FALSE;
+	s_bUseXShm = FALSE;
 	return FALSE;
 #endif
 }
@@ -1091,11 +1252,15 @@ gchar *cairo_dock_get_xwindow_name (Window Xid, gboolean bSearchWmName)
 {
 	Atom aReturnedType = 0;
 	int aReturnedFormat = 0;
-	unsigned long iLeftBytes, iBufferNbElements=0;
+	unsigned long iBufferNbElements=0;
 	guchar *pNameBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmName, 0, G_MAXULONG, False, s_aUtf8String, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, &pNameBuffer);  // on cherche en priorite le nom en UTF8, car on est notifie des 2, mais il vaut mieux eviter le WM_NAME qui, ne l'etant pas, contient des caracteres bizarres qu'on ne peut pas convertir avec g_locale_to_utf8, puisque notre locale _est_ UTF8.
+	_get_xwindow_property (Xid, s_aNetWmName, s_aUtf8String, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &pNameBuffer);  // on cherche en priorite le nom en UTF8, car on est notifie des 2, mais il vaut mieux eviter le WM_NAME qui, ne l'etant pas, contient des caracteres bizarres qu'on ne peut pas convertir avec g_locale_to_utf8, puisque notre locale _est_ UTF8.
 	if (iBufferNbElements == 0 && bSearchWmName)
-		XGetWindowProperty (s_XDisplay, Xid, s_aWmName, 0, G_MAXULONG, False, s_aString, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, &pNameBuffer);
+	{
+		if (pNameBuffer != NULL)
+			XFree (pNameBuffer);
+		_get_xwindow_property (Xid, s_aWmName, s_aString, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &pNameBuffer);
+	}
 	
 	gchar *cName = NULL;
 	if (iBufferNbElements > 0)
@@ -1108,9 +1273,21 @@ gchar *cairo_dock_get_xwindow_name (Window Xid, gboolean bSearchWmName)
 
 gchar *cairo_dock_get_xwindow_class (Window Xid, gchar **cWMClass)
 {
-	XClassHint *pClassHint = XAllocClassHint ();
 	gchar *cClass = NULL, *cWmClass = NULL;
-	if (XGetClassHint (s_XDisplay, Xid, pClassHint) != 0 && pClassHint->res_class)
+	// same as XGetClassHint, except that the property may have been prefetched.
+	Atom aReturnedType = 0;
+	int aReturnedFormat = 0;
+	unsigned long iBufferNbElements = 0;
+	gchar *pClassBuffer = NULL;
+	_get_xwindow_property (Xid, XA_WM_CLASS, XA_STRING, &aReturnedType, &aReturnedFormat, &iBufferNbElements, (guchar **)&pClassBuffer);
+	XClassHint classHint = {NULL, NULL}, *pClassHint = &classHint;
+	if (aReturnedType == XA_STRING && aReturnedFormat == 8 && pClassBuffer != NULL)
+	{
+		pClassHint->res_name = pClassBuffer;
+		gulong iNameLength = strlen (pClassBuffer);
+		pClassHint->res_class = pClassBuffer + MIN (iNameLength + 1, iBufferNbElements);  // the buffer is null-terminated, so res_class is empty if there is no class.
+	}
+	if (pClassHint->res_class)
 	{
 		cWmClass = g_strdup (pClassHint->res_class);
 		
@@ -1169,11 +1346,9 @@ gchar *cairo_dock_get_xwindow_class (Window Xid, gchar **cWMClass)
 		if (str != NULL)
 			*str = '\0';
 		cd_debug ("got an application with class '%s'", cClass);
-		
-		XFree (pClassHint->res_name);
-		XFree (pClassHint->res_class);
-		XFree (pClassHint);
 	}
+	if (pClassBuffer != NULL)
+		XFree (pClassBuffer);
 	if (cWMClass)
 		*cWMClass = cWmClass;
 	else
@@ -1289,9 +1464,9 @@ gboolean cairo_dock_xwindow_is_fullscreen_or_hidden_or_maximized (Window Xid, gb
 	//cd_debug ("%s (%d)", __func__, Xid);
 	Atom aReturnedType = 0;
 	int aReturnedFormat = 0;
-	unsigned long iLeftBytes, iBufferNbElements = 0;
+	unsigned long iBufferNbElements = 0;
 	gulong *pXStateBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmState, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXStateBuffer);
+	_get_xwindow_property (Xid, s_aNetWmState, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, (guchar **)&pXStateBuffer);
 	
 	gboolean bValid = TRUE;
 	*bIsFullScreen = FALSE;
@@ -1386,11 +1561,11 @@ void cairo_dock_xwindow_can_minimize_maximized_close (Window Xid, gboolean *bCan
 int cairo_dock_get_xwindow_desktop (Window Xid)
 {
 	int iDesktopNumber;
-	gulong iLeftBytes, iBufferNbElements = 0;
+	gulong iBufferNbElements = 0;
 	Atom aReturnedType = 0;
 	int aReturnedFormat = 0;
 	gulong *pBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmDesktop, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pBuffer);
+	_get_xwindow_property (Xid, s_aNetWmDesktop, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, (guchar **)&pBuffer);
 	if (iBufferNbElements > 0)
 		iDesktopNumber = *pBuffer;
 	else
@@ -1473,21 +1648,158 @@ Window cairo_dock_get_active_xwindow (void)
 
 
 
-cairo_surface_t *cairo_dock_create_surface_from_xwindow (Window Xid, int iWidth, int iHeight)
+// keep the smallest icon that doesn't need to be scaled up, or the biggest one if they are all too small.
+static inline gboolean _is_better_xicon (gulong w, gulong h, int iWidth, int iHeight, long iBestOffset, gulong iBestWidth, gulong iBestHeight, gboolean bBestBigEnough)
+{
+	gboolean bBigEnough = ((int)w >= iWidth || (int)h >= iHeight);
+	return (iBestOffset < 0
+		|| (bBigEnough && (! bBestBigEnough || w * h < iBestWidth * iBestHeight))
+		|| (! bBigEnough && ! bBestBigEnough && w * h > iBestWidth * iBestHeight));
+}
+
+// _NET_WM_ICON can hold a lot of big icons, so first walk through their sizes, and then only fetch the pixels of the one that fits the best.
+static gulong *_get_best_xicon (Display *display, Window Xid, int iWidth, int iHeight, int *pWidth, int *pHeight)
 {
 	Atom aReturnedType = 0;
 	int aReturnedFormat = 0;
-	unsigned long iLeftBytes, iBufferNbElements = 0;
-	gulong *pXIconBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmIcon, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXIconBuffer);
+	unsigned long iLeftBytes, iBufferNbElements;
+	gulong *pHeader;
+	long iOffset = 0, iTotalSize = 0;  // in 32 bits items, which is the unit of the property
+	long iBestOffset = -1;
+	gulong w, h, iBestWidth = 0, iBestHeight = 0;
+	gboolean bBestBigEnough = FALSE;
+	
+	//\__________________ get the size of each icon.
+	do
+	{
+		pHeader = NULL;
+		iBufferNbElements = 0;
+		XGetWindowProperty (display, Xid, s_aNetWmIcon, iOffset, 2, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pHeader);
+		if (iBufferNbElements < 2)
+		{
+			if (pHeader != NULL)
+				XFree (pHeader);
+			break;
+		}
+		w = pHeader[0];
+		h = pHeader[1];
+		XFree (pHeader);
+		if (iOffset == 0)
+			iTotalSize = 2 + iLeftBytes / 4;
+		if (w == 0 || h == 0 || w > 4096 || h > 4096 || iOffset + 2 + (long)(w * h) > iTotalSize)  // precaution au cas ou un buffer foirreux nous serait retourne.
+		{
+			cd_warning ("This icon is broken !\nThis means that one of the current applications has sent a buggy icon to X.");
+			break;
+		}
+		
+		if (_is_better_xicon (w, h, iWidth, iHeight, iBestOffset, iBestWidth, iBestHeight, bBestBigEnough))
+		{
+			iBestOffset = iOffset;
+			iBestWidth = w;
+			iBestHeight = h;
+			bBestBigEnough = ((int)w >= iWidth || (int)h >= iHeight);
+		}
+		iOffset += 2 + w * h;
+	} while (iOffset + 2 < iTotalSize);
+	if (iBestOffset < 0)
+		return NULL;
+	
+	//\__________________ get the pixels of the chosen one.
+	gulong *pPixels = NULL;
+	iBufferNbElements = 0;
+	XGetWindowProperty (display, Xid, s_aNetWmIcon, iBestOffset + 2, iBestWidth * iBestHeight, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pPixels);
+	if (iBufferNbElements < iBestWidth * iBestHeight)  // the icon has changed in the meantime.
+	{
+		if (pPixels != NULL)
+			XFree (pPixels);
+		return NULL;
+	}
+	*pWidth = iBestWidth;
+	*pHeight = iBestHeight;
+	return pPixels;
+}
 
-	if (iBufferNbElements > 2)
+// same as above, on a XCB connection; a window destroyed in the meantime just gives an error in the reply. The pixels are returned as longs, like Xlib does, and are to be freed with g_free.
+static gulong *_get_best_xicon_xcb (xcb_connection_t *pConnection, Window Xid, int iWidth, int iHeight, int *pWidth, int *pHeight)
+{
+	xcb_get_property_cookie_t cookie;
+	xcb_get_property_reply_t *pReply;
+	xcb_generic_error_t *pError;
+	const uint32_t *pValue;
+	long iOffset = 0, iTotalSize = 0;  // in 32 bits items, which is the unit of the property
+	long iBestOffset = -1;
+	gulong w, h, iBestWidth = 0, iBestHeight = 0;
+	gboolean bBestBigEnough = FALSE;
+	
+	//\__________________ get the size of each icon.
+	do
 	{
-		cairo_surface_t *pNewSurface = cairo_dock_create_surface_from_xicon_buffer (pXIconBuffer,
-			iBufferNbElements,
+		pError = NULL;
+		cookie = xcb_get_property (pConnection, 0, Xid, s_aNetWmIcon, XCB_ATOM_CARDINAL, iOffset, 2);
+		pReply = xcb_get_property_reply (pConnection, cookie, &pError);
+		if (pError != NULL || pReply == NULL || pReply->format != 32 || xcb_get_property_value_length (pReply) < 2 * 4)
+		{
+			free (pError);
+			free (pReply);
+			break;
+		}
+		pValue = xcb_get_property_value (pReply);
+		w = pValue[0];
+		h = pValue[1];
+		if (iOffset == 0)
+			iTotalSize = 2 + pReply->bytes_after / 4;
+		free (pReply);
+		if (w == 0 || h == 0 || w > 4096 || h > 4096 || iOffset + 2 + (long)(w * h) > iTotalSize)  // precaution au cas ou un buffer foirreux nous serait retourne.
+		{
+			cd_warning ("This icon is broken !\nThis means that one of the current applications has sent a buggy icon to X.");
+			break;
+		}
+		
+		if (_is_better_xicon (w, h, iWidth, iHeight, iBestOffset, iBestWidth, iBestHeight, bBestBigEnough))
+		{
+			iBestOffset = iOffset;
+			iBestWidth = w;
+			iBestHeight = h;
+			bBestBigEnough = ((int)w >= iWidth || (int)h >= iHeight);
+		}
+		iOffset += 2 + w * h;
+	} while (iOffset + 2 < iTotalSize);
+	if (iBestOffset < 0)
+		return NULL;
+	
+	//\__________________ get the pixels of the chosen one.
+	pError = NULL;
+	cookie = xcb_get_property (pConnection, 0, Xid, s_aNetWmIcon, XCB_ATOM_CARDINAL, iBestOffset + 2, iBestWidth * iBestHeight);
+	pReply = xcb_get_property_reply (pConnection, cookie, &pError);
+	if (pError != NULL || pReply == NULL || pReply->format != 32 || (gulong)xcb_get_property_value_length (pReply) < iBestWidth * iBestHeight * 4)  // the icon has changed in the meantime.
+	{
+		free (pError);
+		free (pReply);
+		return NULL;
+	}
+	pValue = xcb_get_property_value (pReply);
+	gulong *pPixels = g_new (gulong, iBestWidth * iBestHeight);
+	gulong i;
+	for (i = 0; i < iBestWidth * iBestHeight; i ++)
+		pPixels[i] = pValue[i];
+	free (pReply);
+	*pWidth = iBestWidth;
+	*pHeight = iBestHeight;
+	return pPixels;
+}
+
+cairo_surface_t *cairo_dock_create_surface_from_xwindow (Window Xid, int iWidth, int iHeight)
+{
+	int w, h;
+	gulong *pXIconPixels = _get_best_xicon (s_XDisplay, Xid, iWidth, iHeight, &w, &h);
+	if (pXIconPixels != NULL)
+	{
+		cairo_surface_t *pNewSurface = cairo_dock_create_surface_from_xicon_pixels (pXIconPixels,
+			w, h,
 			iWidth,
-			iHeight);
-		XFree (pXIconBuffer);
+			iHeight,
+			FALSE);
+		XFree (pXIconPixels);
 		return pNewSurface;
 	}
 	else  // sinon on tente avec l'icone eventuellement presente dans les WMHints.
@@ -1568,9 +1880,126 @@ cairo_surface_t *cairo_dock_create_surface_from_xwindow (Window Xid, int iWidth,
 	}
 }
 
+cairo_surface_t *cairo_dock_create_surface_from_xwindow_threaded (Window Xid, int iWidth, int iHeight)
+{
+	G_LOCK (s_pWorkerConnection);
+	if (s_pWorkerConnection == NULL)
+	{
+		s_pWorkerConnection = xcb_connect (DisplayString (s_XDisplay), NULL);
+		if (xcb_connection_has_error (s_pWorkerConnection))
+		{
+			xcb_disconnect (s_pWorkerConnection);
+			s_pWorkerConnection = NULL;
+			G_UNLOCK (s_pWorkerConnection);
+			cd_warning ("couldn't open a connection to the X server for the worker threads");
+			return NULL;
+		}
+	}
+	xcb_connection_t *pConnection = s_pWorkerConnection;
+	G_UNLOCK (s_pWorkerConnection);  // XCB can be used by several threads at once.
+	
+	// only _NET_WM_ICON can be got this way; the WM hints' pixmaps need GDK, which is only usable in the main thread.
+	int w, h;
+	gulong *pXIconPixels = _get_best_xicon_xcb (pConnection, Xid, iWidth, iHeight, &w, &h);  // atoms are global to the server, so they are valid on this connection too.
+	
+	cairo_surface_t *pNewSurface = NULL;
+	if (pXIconPixels != NULL)
+	{
+		pNewSurface = cairo_dock_create_surface_from_xicon_pixels (pXIconPixels,
+			w, h,
+			iWidth,
+			iHeight,
+			TRUE);
+		g_free (pXIconPixels);
+	}
+	return pNewSurface;
+}
+
+#ifdef HAVE_XEXTEND
+// get the content of the pixmap in a shared memory segment, and scale it directly into the surface; this avoids the copies of the GdkPixbuf way, which are costly with big windows.
+static cairo_surface_t *_create_surface_from_xpixmap_shm (Pixmap Xid, int iWidth, int iHeight)
+{
+	//\__________________ get the size and format of the pixmap.
+	Window root;  // inutile.
+	int x, y;  // inutile.
+	guint border_width;  // inutile.
+	guint w, h, iDepth;
+	if (! XGetGeometry (s_XDisplay,
+		Xid, &root, &x, &y,
+		&w, &h, &border_width, &iDepth))
+		return NULL;
+	if (iDepth != 24 && iDepth != 32)  // only the formats that cairo can read as is.
+		return NULL;
+	XVisualInfo vinfo;
+	if (! XMatchVisualInfo (s_XDisplay, DefaultScreen (s_XDisplay), iDepth, TrueColor, &vinfo)
+	|| vinfo.red_mask != 0xFF0000 || vinfo.green_mask != 0x00FF00 || vinfo.blue_mask != 0x0000FF)
+		return NULL;
+	
+	XShmSegmentInfo shminfo;
+	XImage *pXImage = XShmCreateImage (s_XDisplay, vinfo.visual, iDepth, ZPixmap, NULL, &shminfo, w, h);
+	if (pXImage == NULL)
+		return NULL;
+	if (pXImage->bits_per_pixel != 32 || pXImage->byte_order != (G_BYTE_ORDER == G_LITTLE_ENDIAN ? LSBFirst : MSBFirst))
+	{
+		XDestroyImage (pXImage);
+		return NULL;
+	}
+	
+	//\__________________ make the shared memory segment.
+	shminfo.shmid = shmget (IPC_PRIVATE, pXImage->bytes_per_line * pXImage->height, IPC_CREAT | 0600);
+	if (shminfo.shmid < 0)
+	{
+		XDestroyImage (pXImage);
+		return NULL;
+	}
+	shminfo.shmaddr = pXImage->data = shmat (shminfo.shmid, NULL, 0);
+	shminfo.readOnly = False;
+	
+	//\__________________ let the server copy the pixmap into it, and scale it into the icon, keeping the ratio.
+	cairo_surface_t *pNewSurface = NULL;
+	if (shminfo.shmaddr != (char*)-1 && XShmAttach (s_XDisplay, &shminfo))
+	{
+		error_code = Success;
+		if (XShmGetImage (s_XDisplay, Xid, pXImage, 0, 0, AllPlanes) && error_code == Success)
+		{
+			cd_debug ("window pixmap : %dx%d (shm)", w, h);
+			cairo_surface_t *pWindowSurface = cairo_image_surface_create_for_data ((guchar *)pXImage->data,
+				iDepth == 32 ? CAIRO_FORMAT_ARGB32 : CAIRO_FORMAT_RGB24,
+				w, h,
+				pXImage->bytes_per_line);
+			double fScale = MIN ((double)iWidth / w, (double)iHeight / h);
+			pNewSurface = cairo_dock_create_blank_surface (iWidth, iHeight);
+			cairo_t *pCairoContext = cairo_create (pNewSurface);
+			cairo_translate (pCairoContext, (iWidth - w * fScale) / 2, (iHeight - h * fScale) / 2);
+			cairo_scale (pCairoContext, fScale, fScale);
+			cairo_set_source_surface (pCairoContext, pWindowSurface, 0, 0);
+			cairo_paint (pCairoContext);
+			cairo_destroy (pCairoContext);
+			cairo_surface_destroy (pWindowSurface);
+		}
+		XShmDetach (s_XDisplay, &shminfo);
+	}
+	
+	if (shminfo.shmaddr != (char*)-1)
+		shmdt (shminfo.shmaddr);
+	shmctl (shminfo.shmid, IPC_RMID, NULL);
+	pXImage->data = NULL;  // not allocated by Xlib
+	XDestroyImage (pXImage);
+	return pNewSurface;
+}
+#endif
+
 cairo_surface_t *cairo_dock_create_surface_from_xpixmap (Pixmap Xid, int iWidth, int iHeight)
 {
 	g_return_val_if_fail (Xid > 0, NULL);
+	#ifdef HAVE_XEXTEND
+	if (s_bUseXShm)
+	{
+		cairo_surface_t *pSurface = _create_surface_from_xpixmap_shm (Xid, iWidth, iHeight);
+		if (pSurface != NULL)
+			return pSurface;
+	}  // else the pixmap is in a format we don't handle this way, or the X server is remote -> go through a GdkPixbuf.
+	#endif
 	GdkPixbuf *pPixbuf = cairo_dock_get_pixbuf_from_pixmap (Xid, TRUE);
 	if (pPixbuf == NULL)
 	{
@@ -1745,14 +2174,30 @@ GLuint cairo_dock_texture_from_pixmap (Window Xid, Pixmap iBackingPixmap)
 	return cCommand;
 }*/
 
+Window cairo_dock_get_xwindow_transient_for (Window Xid)
+{
+	// same as XGetTransientForHint, except that the property may have been prefetched.
+	Atom aReturnedType = 0;
+	int aReturnedFormat = 0;
+	unsigned long iBufferNbElements = 0;
+	gulong *pBuffer = NULL;
+	_get_xwindow_property (Xid, XA_WM_TRANSIENT_FOR, XA_WINDOW, &aReturnedType, &aReturnedFormat, &iBufferNbElements, (guchar **)&pBuffer);
+	Window iTransientFor = None;
+	if (aReturnedType == XA_WINDOW && aReturnedFormat == 32 && iBufferNbElements > 0)
+		iTransientFor = *pBuffer;
+	if (pBuffer != NULL)
+		XFree (pBuffer);
+	return iTransientFor;
+}
+
 gboolean cairo_dock_get_xwindow_type (Window Xid, Window *pTransientFor)
 {
 	gboolean bKeep = FALSE;  // we only want to know if we can display this window in the dock or not, so a boolean is enough.
 	Atom aReturnedType = 0;
 	int aReturnedFormat = 0;
-	unsigned long iLeftBytes, iBufferNbElements;
+	unsigned long iBufferNbElements = 0;
 	gulong *pTypeBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmWindowType, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pTypeBuffer);
+	_get_xwindow_property (Xid, s_aNetWmWindowType, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, (guchar **)&pTypeBuffer);
 	if (iBufferNbElements != 0)
 	{
 		guint i;
@@ -1765,7 +2210,7 @@ gboolean cairo_dock_get_xwindow_type (Window Xid, Window *pTransientFor)
 			}
 			if (pTypeBuffer[i] == s_aNetWmWindowTypeDialog)  // dialog -> skip modal dialog, because we can't act on it independantly from the parent window (it's most probably a dialog box like an open/save dialog)
 			{
-				XGetTransientForHint (s_XDisplay, Xid, pTransientFor);  // maybe we should also get the _NET_WM_STATE_MODAL property, although if a dialog is set modal but not transient, that would probably be an error from the application.
+				*pTransientFor = cairo_dock_get_xwindow_transient_for (Xid);  // maybe we should also get the _NET_WM_STATE_MODAL property, although if a dialog is set modal but not transient, that would probably be an error from the application.
 				if (*pTransientFor == None)
 				{
 					bKeep = TRUE;
@@ -1781,7 +2226,7 @@ gboolean cairo_dock_get_xwindow_type (Window Xid, Window *pTransientFor)
 	}
 	else  // no type, take it by default, unless it's transient.
 	{
-		XGetTransientForHint (s_XDisplay, Xid, pTransientFor);
+		*pTransientFor = cairo_dock_get_xwindow_transient_for (Xid);
 		bKeep = (*pTransientFor == None);
 	}
 	return bKeep;
@@ -116,6 +116,9 @@ Window cairo_dock_get_active_xwindow (void);
 
 cairo_surface_t *cairo_dock_create_surface_from_xwindow (Window Xid, int iWidth, int iHeight);
 
+// can be called from a thread; only uses _NET_WM_ICON, returns NULL if the window doesn't define it.
+cairo_surface_t *cairo_dock_create_surface_from_xwindow_threaded (Window Xid, int iWidth, int iHeight);
+
 cairo_surface_t *cairo_dock_create_surface_from_xpixmap (Pixmap Xid, int iWidth, int iHeight);
 
 GLuint cairo_dock_texture_from_pixmap (Window Xid, Pixmap iBackingPixmap);
@@ -123,6 +126,16 @@ GLuint cairo_dock_texture_from_pixmap (Window Xid, Pixmap iBackingPixmap);
 
 gboolean cairo_dock_get_xwindow_type (Window Xid, Window *pTransientFor);
 
+Window cairo_dock_get_xwindow_transient_for (Window Xid);
+
+/* Get at once the properties that are read when new windows appear (state, type, class, name, desktop), so that we don't pay the latency of the connection to the X server for each of them (it can be several ms on a remote display).
+ * The following getters will use them instead of querying the server, until cairo_dock_clear_prefetched_xwindows_properties is called; each prefetched property is only used once.
+ * It needs XCB, and does nothing otherwise.
+ */
+void cairo_dock_prefetch_xwindows_properties (Window *pXids, gulong iNbWindows);
+
+void cairo_dock_clear_prefetched_xwindows_properties (void);
+
 gboolean cairo_dock_xcomposite_is_available (void);
 
 
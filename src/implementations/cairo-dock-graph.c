@@ -42,31 +42,26 @@ typedef struct _Graph {
 	GLuint iBackgroundTexture;
 	gint iMargin;
 	gboolean bMixGraphs;
+	cairo_surface_t *pCurvesSurface;  // the curves alone, scrolled as new values come.
+	cairo_surface_t *pScrollSurface;  // a surface of the same size, used to scroll the previous one.
+	guint iCurvesNbPushedValues;  // number of values that had been pushed when the curves were drawn.
+	gint iCurvesMemorySize;
+	gdouble *pCurvesMinMaxValues;  // scale of the drawn curves.
 	} Graph;
 
+#define CD_GRAPH_SCROLL_MIN_WIDTH 8
+
 
 extern gboolean g_bUseOpenGL;
 
 
-static void render (Graph *pGraph, cairo_t *pCairoContext)
+// Draw the curve of the i-th value, from the value of age t0 to the one of age t1 (excluded).
+static void _draw_curve (Graph *pGraph, cairo_t *pCairoContext, int i, int t0, int t1)
 {
-	g_return_if_fail (pGraph != NULL);
-	g_return_if_fail (pCairoContext != NULL && cairo_status (pCairoContext) == CAIRO_STATUS_SUCCESS);
-	
 	CairoDataRenderer *pRenderer = CAIRO_DATA_RENDERER (pGraph);
 	CairoDataToRenderer *pData = cairo_data_renderer_get_data (pRenderer);
 	int iNbValues = cairo_data_renderer_get_nb_values (pRenderer);
-	
-	if (pGraph->pBackgroundSurface != NULL)
-	{
-		cairo_set_source_surface (pCairoContext, pGraph->pBackgroundSurface, 0., 0.);
-		cairo_paint (pCairoContext);
-	}
-
-	g_return_if_fail (pRenderer->iRank != 0); // workaround: FIXME
 	int iNbDrawings = iNbValues / pRenderer->iRank;
-	if (iNbDrawings == 0)
-		return;
 	
 	int iMargin = pGraph->iMargin;
 	int iWidth = pRenderer->iWidth - 2*iMargin;
@@ -76,133 +71,259 @@ static void render (Graph *pGraph, cairo_t *pCairoContext)
 	double fValue;
 	cairo_pattern_t *pGradationPattern;
 	int t, n = MIN (pData->iMemorySize, iWidth);  // for iteration over the memorized values.
-	int i, iCurrentGraph, iGraphTop, iGraphBottom, iHeight = 0;
-	for (i = 0; i < iNbValues; i ++)
+	int iCurrentGraph, iGraphTop, iGraphBottom, iHeight = 0;
+	cairo_save (pCairoContext);
+	if (pGraph->iType == CAIRO_DOCK_GRAPH_CIRCLE || pGraph->iType == CAIRO_DOCK_GRAPH_CIRCLE_PLAIN)
 	{
-		cairo_save (pCairoContext);
-		if (pGraph->iType == CAIRO_DOCK_GRAPH_CIRCLE || pGraph->iType == CAIRO_DOCK_GRAPH_CIRCLE_PLAIN)
-		{
-			if (! pGraph->bMixGraphs)
-				cairo_translate (pCairoContext,
-					0.,
-					i * fHeight);
-		}
-		else
-		{
-			iCurrentGraph = pGraph->bMixGraphs ? 0 : i;
-			iGraphTop = floor (iCurrentGraph * fHeight) + iMargin; // Position of previous graph axis (if any).
-			iGraphBottom = floor ((iCurrentGraph + 1) * fHeight) + iMargin; // Position of current graph axis
-			iHeight = iGraphBottom - iGraphTop; // Current graph height.
+		if (! pGraph->bMixGraphs)
 			cairo_translate (pCairoContext,
-				iMargin,
-				iGraphTop);
-		}
-		pGradationPattern = pGraph->pGradationPatterns[i];
-		if (pGradationPattern != NULL)
-			cairo_set_source (pCairoContext, pGradationPattern);
-		else
-			cairo_set_source_rgb (pCairoContext,
-				pGraph->fLowColor[3*i+0],
-				pGraph->fLowColor[3*i+1],
-				pGraph->fLowColor[3*i+2]);
-		
-		switch (pGraph->iType)
-		{
-			case CAIRO_DOCK_GRAPH_LINE:
-			case CAIRO_DOCK_GRAPH_PLAIN:
-			default :
-				cairo_set_line_width (pCairoContext, 1);
-				cairo_set_line_join (pCairoContext, CAIRO_LINE_JOIN_ROUND);
-				fValue = cairo_data_renderer_get_normalized_current_value (pRenderer, i);
+				0.,
+				i * fHeight);
+	}
+	else
+	{
+		iCurrentGraph = pGraph->bMixGraphs ? 0 : i;
+		iGraphTop = floor (iCurrentGraph * fHeight) + iMargin; // Position of previous graph axis (if any).
+		iGraphBottom = floor ((iCurrentGraph + 1) * fHeight) + iMargin; // Position of current graph axis
+		iHeight = iGraphBottom - iGraphTop; // Current graph height.
+		cairo_translate (pCairoContext,
+			iMargin,
+			iGraphTop);
+	}
+	pGradationPattern = pGraph->pGradationPatterns[i];
+	if (pGradationPattern != NULL)
+		cairo_set_source (pCairoContext, pGradationPattern);
+	else
+		cairo_set_source_rgb (pCairoContext,
+			pGraph->fLowColor[3*i+0],
+			pGraph->fLowColor[3*i+1],
+			pGraph->fLowColor[3*i+2]);
+	
+	switch (pGraph->iType)
+	{
+		case CAIRO_DOCK_GRAPH_LINE:
+		case CAIRO_DOCK_GRAPH_PLAIN:
+		default :
+			cairo_set_line_width (pCairoContext, 1);
+			cairo_set_line_join (pCairoContext, CAIRO_LINE_JOIN_ROUND);
+			fValue = cairo_data_renderer_get_normalized_value (pRenderer, i, -t0);
+			if (fValue <= CAIRO_DATA_RENDERER_UNDEF_VALUE+1)  // undef value -> let's draw 0
+				fValue = 0;
+			cairo_move_to (pCairoContext,
+				iWidth - t0 - .5,
+				(1 - fValue) * (iHeight - 1) + .5) ; // - .5 to align line draw on pixel and + 1 px down because size is reduced
+			for (t = t0 + 1; t < t1; t ++)
+			{
+				fValue = cairo_data_renderer_get_normalized_value (pRenderer, i, -t);
 				if (fValue <= CAIRO_DATA_RENDERER_UNDEF_VALUE+1)  // undef value -> let's draw 0
 					fValue = 0;
-				cairo_move_to (pCairoContext,
-					iWidth - .5,
-					(1 - fValue) * (iHeight - 1) + .5) ; // - .5 to align line draw on pixel and + 1 px down because size is reduced
-				for (t = 1; t < n; t ++)
-				{
-					fValue = cairo_data_renderer_get_normalized_value (pRenderer, i, -t);
-					if (fValue <= CAIRO_DATA_RENDERER_UNDEF_VALUE+1)  // undef value -> let's draw 0
-						fValue = 0;
-					cairo_line_to (pCairoContext,
-						iWidth - t - .5,
-						(1 - fValue) * (iHeight - 1) + .5); // - .5 to align line draw on pixel and + 1 px down because size is reduced
-				}
-				if (pGraph->iType == CAIRO_DOCK_GRAPH_PLAIN)
-				{
-					cairo_line_to (pCairoContext,
-						.5, // - .5 to align line draw on pixel and + 1 to align with last value position
-						iHeight - .5); // - .5 to align next line draw on pixel
-					cairo_rel_line_to (pCairoContext,
-						iWidth - 1,
-						0.);
-					cairo_close_path (pCairoContext);
-					cairo_fill_preserve (pCairoContext);
-				}
-				cairo_stroke (pCairoContext);
-			break;
-			
-			case CAIRO_DOCK_GRAPH_BAR:
+				cairo_line_to (pCairoContext,
+					iWidth - t - .5,
+					(1 - fValue) * (iHeight - 1) + .5); // - .5 to align line draw on pixel and + 1 px down because size is reduced
+			}
+			if (pGraph->iType == CAIRO_DOCK_GRAPH_PLAIN)
+			{
+				cairo_line_to (pCairoContext,
+					.5, // - .5 to align line draw on pixel and + 1 to align with last value position
+					iHeight - .5); // - .5 to align next line draw on pixel
+				cairo_rel_line_to (pCairoContext,
+					iWidth - 1,
+					0.);
+				cairo_close_path (pCairoContext);
+				cairo_fill_preserve (pCairoContext);
+			}
+			cairo_stroke (pCairoContext);
+		break;
+		
+		case CAIRO_DOCK_GRAPH_BAR:
+		{
+			cairo_set_line_width (pCairoContext, 1);
+			for (t = t0; t < t1; t ++)
 			{
-				cairo_set_line_width (pCairoContext, 1);
-				for (t = 0; t < n; t ++)
+				fValue = cairo_data_renderer_get_normalized_value (pRenderer, i, -t);
+				if (fValue > CAIRO_DATA_RENDERER_UNDEF_VALUE+1)  // undef value -> no draw
 				{
-					fValue = cairo_data_renderer_get_normalized_value (pRenderer, i, -t);
-					if (fValue > CAIRO_DATA_RENDERER_UNDEF_VALUE+1)  // undef value -> no draw
-					{
-						cairo_move_to (pCairoContext,
-							iWidth - t - .5, // - .5 to align line draw on pixel
-							iHeight);
-						cairo_rel_line_to (pCairoContext,
-							0.,
-							- fValue * iHeight);
-						cairo_stroke (pCairoContext);
-					}
+					cairo_move_to (pCairoContext,
+						iWidth - t - .5, // - .5 to align line draw on pixel
+						iHeight);
+					cairo_rel_line_to (pCairoContext,
+						0.,
+						- fValue * iHeight);
+					cairo_stroke (pCairoContext);
 				}
 			}
-			break;
-			
-			case CAIRO_DOCK_GRAPH_CIRCLE:
-			case CAIRO_DOCK_GRAPH_CIRCLE_PLAIN:
-				cairo_set_line_width (pCairoContext, 1);
-				cairo_set_line_join (pCairoContext, CAIRO_LINE_JOIN_ROUND);
-				fValue = cairo_data_renderer_get_normalized_current_value (pRenderer, i);
+		}
+		break;
+		
+		case CAIRO_DOCK_GRAPH_CIRCLE:
+		case CAIRO_DOCK_GRAPH_CIRCLE_PLAIN:
+			cairo_set_line_width (pCairoContext, 1);
+			cairo_set_line_join (pCairoContext, CAIRO_LINE_JOIN_ROUND);
+			fValue = cairo_data_renderer_get_normalized_current_value (pRenderer, i);
+			if (fValue <= CAIRO_DATA_RENDERER_UNDEF_VALUE+1)  // undef value -> let's draw 0
+				fValue = 0;
+			double angle, radius = MIN (iWidth, fHeight)/2;
+			angle = -2*G_PI*(-.5/pData->iMemorySize);
+			cairo_move_to (pCairoContext,
+				iMargin + iWidth/2 + radius * (fValue * cos (angle)),
+				iMargin + fHeight/2 + radius * (fValue * sin (angle)));
+			angle = -2*G_PI*(.5/pData->iMemorySize);
+			cairo_line_to (pCairoContext,
+				iMargin + iWidth/2 + radius * (fValue * cos (angle)),
+				iMargin + fHeight/2 + radius * (fValue * sin (angle)));
+			for (t = 1; t < n; t ++)
+			{
+				fValue = cairo_data_renderer_get_normalized_value (pRenderer, i, -t);
 				if (fValue <= CAIRO_DATA_RENDERER_UNDEF_VALUE+1)  // undef value -> let's draw 0
 					fValue = 0;
-				double angle, radius = MIN (iWidth, fHeight)/2;
-				angle = -2*G_PI*(-.5/pData->iMemorySize);
-				cairo_move_to (pCairoContext,
+				angle = -2*G_PI*((t-.5)/n);
+				cairo_line_to (pCairoContext,
 					iMargin + iWidth/2 + radius * (fValue * cos (angle)),
 					iMargin + fHeight/2 + radius * (fValue * sin (angle)));
-				angle = -2*G_PI*(.5/pData->iMemorySize);
+				angle = -2*G_PI*((t+.5)/n);
 				cairo_line_to (pCairoContext,
 					iMargin + iWidth/2 + radius * (fValue * cos (angle)),
 					iMargin + fHeight/2 + radius * (fValue * sin (angle)));
-				for (t = 1; t < n; t ++)
-				{
-					fValue = cairo_data_renderer_get_normalized_value (pRenderer, i, -t);
-					if (fValue <= CAIRO_DATA_RENDERER_UNDEF_VALUE+1)  // undef value -> let's draw 0
-						fValue = 0;
-					angle = -2*G_PI*((t-.5)/n);
-					cairo_line_to (pCairoContext,
-						iMargin + iWidth/2 + radius * (fValue * cos (angle)),
-						iMargin + fHeight/2 + radius * (fValue * sin (angle)));
-					angle = -2*G_PI*((t+.5)/n);
-					cairo_line_to (pCairoContext,
-						iMargin + iWidth/2 + radius * (fValue * cos (angle)),
-						iMargin + fHeight/2 + radius * (fValue * sin (angle)));
-				}
-				if (pGraph->iType == CAIRO_DOCK_GRAPH_CIRCLE_PLAIN)
-				{
-					cairo_close_path (pCairoContext);
-					cairo_fill_preserve (pCairoContext);
-				}
-				cairo_stroke (pCairoContext);
-			break;
-		}
-		cairo_restore (pCairoContext);
+			}
+			if (pGraph->iType == CAIRO_DOCK_GRAPH_CIRCLE_PLAIN)
+			{
+				cairo_close_path (pCairoContext);
+				cairo_fill_preserve (pCairoContext);
+			}
+			cairo_stroke (pCairoContext);
+		break;
+	}
+	cairo_restore (pCairoContext);
+}
+
+// Line and bar graphs only slide by one column for each new value: they are drawn on a surface that is scrolled, and only the columns that changed are drawn again.
+static inline gboolean _graph_can_scroll (Graph *pGraph)
+{
+	CairoDataRenderer *pRenderer = CAIRO_DATA_RENDERER (pGraph);
+	CairoDataToRenderer *pData = cairo_data_renderer_get_data (pRenderer);
+	int iWidth = pRenderer->iWidth - 2*pGraph->iMargin;
+	return (pGraph->iType != CAIRO_DOCK_GRAPH_CIRCLE && pGraph->iType != CAIRO_DOCK_GRAPH_CIRCLE_PLAIN
+		&& pData->iMemorySize >= iWidth  // the curves fill the whole width, so nothing special happens on their left end.
+		&& iWidth > CD_GRAPH_SCROLL_MIN_WIDTH);
+}
+
+static void _redraw_curves_in_columns (Graph *pGraph, cairo_t *pCairoContext, int x, int w, int t0, int t1)
+{
+	CairoDataRenderer *pRenderer = CAIRO_DATA_RENDERER (pGraph);
+	int iNbValues = cairo_data_renderer_get_nb_values (pRenderer);
+	cairo_save (pCairoContext);
+	cairo_rectangle (pCairoContext, x, 0., w, pRenderer->iHeight);
+	cairo_clip (pCairoContext);
+	cairo_set_operator (pCairoContext, CAIRO_OPERATOR_CLEAR);
+	cairo_paint (pCairoContext);
+	cairo_set_operator (pCairoContext, CAIRO_OPERATOR_OVER);
+	int i;
+	for (i = 0; i < iNbValues; i ++)
+	{
+		_draw_curve (pGraph, pCairoContext, i, t0, t1);
+	}
+	cairo_restore (pCairoContext);
+}
+
+static void _update_curves_surface (Graph *pGraph)
+{
+	CairoDataRenderer *pRenderer = CAIRO_DATA_RENDERER (pGraph);
+	CairoDataToRenderer *pData = cairo_data_renderer_get_data (pRenderer);
+	int iNbValues = cairo_data_renderer_get_nb_values (pRenderer);
+	int iMargin = pGraph->iMargin;
+	int iWidth = pRenderer->iWidth - 2*iMargin;
+	int n = MIN (pData->iMemorySize, iWidth);
+	
+	//\_______________ see what has changed since the last drawing.
+	guint iNbNewValues = pData->iNbPushedValues - pGraph->iCurvesNbPushedValues;
+	gboolean bFullRedraw = (pGraph->pCurvesSurface == NULL
+		|| pGraph->iCurvesMemorySize != pData->iMemorySize
+		|| memcmp (pGraph->pCurvesMinMaxValues, pData->pMinMaxValues, 2 * iNbValues * sizeof (gdouble)) != 0  // the scale has changed, all the curves move.
+		|| iNbNewValues + 2 >= (guint)n);
+	if (! bFullRedraw && iNbNewValues == 0)
+		return;
+	pGraph->iCurvesNbPushedValues = pData->iNbPushedValues;
+	pGraph->iCurvesMemorySize = pData->iMemorySize;
+	memcpy (pGraph->pCurvesMinMaxValues, pData->pMinMaxValues, 2 * iNbValues * sizeof (gdouble));
+	
+	if (pGraph->pCurvesSurface == NULL)
+	{
+		pGraph->pCurvesSurface = cairo_dock_create_blank_surface (pRenderer->iWidth, pRenderer->iHeight);
+		pGraph->pScrollSurface = cairo_dock_create_blank_surface (pRenderer->iWidth, pRenderer->iHeight);
+	}
+	
+	cairo_t *pCairoContext;
+	if (bFullRedraw)
+	{
+		pCairoContext = cairo_create (pGraph->pCurvesSurface);
+		_redraw_curves_in_columns (pGraph, pCairoContext, 0, pRenderer->iWidth, 0, n);
+		cairo_destroy (pCairoContext);
+		return;
+	}
+	
+	//\_______________ scroll the curves to the left, into the other surface, and swap them.
+	pCairoContext = cairo_create (pGraph->pScrollSurface);
+	cairo_rectangle (pCairoContext, iMargin, 0., iWidth, pRenderer->iHeight);
+	cairo_clip (pCairoContext);
+	cairo_set_operator (pCairoContext, CAIRO_OPERATOR_SOURCE);
+	cairo_set_source_surface (pCairoContext, pGraph->pCurvesSurface, - (double)iNbNewValues, 0.);
+	cairo_paint (pCairoContext);
+	cairo_destroy (pCairoContext);
+	
+	cairo_surface_t *pSurface = pGraph->pCurvesSurface;
+	pGraph->pCurvesSurface = pGraph->pScrollSurface;
+	pGraph->pScrollSurface = pSurface;
+	
+	//\_______________ draw the new columns, plus the former last one (plain graphs close their path there), and the first one (where the oldest value is now).
+	pCairoContext = cairo_create (pGraph->pCurvesSurface);
+	int k = iNbNewValues + 1;
+	_redraw_curves_in_columns (pGraph, pCairoContext, iMargin + iWidth - k, k, 0, k + 1);  // the segment coming from the left neighbour must be drawn too.
+	_redraw_curves_in_columns (pGraph, pCairoContext, iMargin, 1, n - 3, n);
+	cairo_destroy (pCairoContext);
+}
+
+static void render (Graph *pGraph, cairo_t *pCairoContext)
+{
+	g_return_if_fail (pGraph != NULL);
+	g_return_if_fail (pCairoContext != NULL && cairo_status (pCairoContext) == CAIRO_STATUS_SUCCESS);
+	
+	CairoDataRenderer *pRenderer = CAIRO_DATA_RENDERER (pGraph);
+	CairoDataToRenderer *pData = cairo_data_renderer_get_data (pRenderer);
+	int iNbValues = cairo_data_renderer_get_nb_values (pRenderer);
+	
+	if (pGraph->pBackgroundSurface != NULL)
+	{
+		cairo_set_source_surface (pCairoContext, pGraph->pBackgroundSurface, 0., 0.);
+		cairo_paint (pCairoContext);
+	}
+
+	g_return_if_fail (pRenderer->iRank != 0); // workaround: FIXME
+	int iNbDrawings = iNbValues / pRenderer->iRank;
+	if (iNbDrawings == 0)
+		return;
+	
+	int i;
+	if (_graph_can_scroll (pGraph))
+	{
+		_update_curves_surface (pGraph);
+		cairo_set_source_surface (pCairoContext, pGraph->pCurvesSurface, 0., 0.);
+		cairo_paint (pCairoContext);
 		
-		cairo_dock_render_overlays_to_context (pRenderer, i, pCairoContext);
+		for (i = 0; i < iNbValues; i ++)
+		{
+			cairo_dock_render_overlays_to_context (pRenderer, i, pCairoContext);
+		}
+	}
+	else
+	{
+		int iWidth = pRenderer->iWidth - 2*pGraph->iMargin;
+		int n = MIN (pData->iMemorySize, iWidth);
+		for (i = 0; i < iNbValues; i ++)
+		{
+			_draw_curve (pGraph, pCairoContext, i, 0, n);
+			
+			cairo_dock_render_overlays_to_context (pRenderer, i, pCairoContext);
+		}
 	}
 }
 /* not used
@@ -461,6 +582,7 @@ static void load (Graph *pGraph, G_GNUC_UNUSED Icon *pIcon, CairoGraphAttribute
 	}
 
 	pGraph->iMargin = floor (MIN (iWidth, iHeight) / 32);
+	pGraph->pCurvesMinMaxValues = g_new0 (gdouble, 2 * iNbValues);
 
 	if (pAttribute->fBackGroundColor != NULL)
 		memcpy (pGraph->fBackGroundColor, pAttribute->fBackGroundColor, 4 * sizeof (double));
@@ -479,12 +601,29 @@ static void load (Graph *pGraph, G_GNUC_UNUSED Icon *pIcon, CairoGraphAttribute
 }
 
 
+static void _free_curves_surfaces (Graph *pGraph)
+{
+	if (pGraph->pCurvesSurface != NULL)
+	{
+		cairo_surface_destroy (pGraph->pCurvesSurface);
+		pGraph->pCurvesSurface = NULL;
+	}
+	if (pGraph->pScrollSurface != NULL)
+	{
+		cairo_surface_destroy (pGraph->pScrollSurface);
+		pGraph->pScrollSurface = NULL;
+	}
+}
+
 static void reload (Graph *pGraph)
 {
 	CairoDataRenderer *pRenderer = CAIRO_DATA_RENDERER (pGraph);
 	int iNbValues = cairo_data_renderer_get_nb_values (pRenderer);
 	int iWidth = pRenderer->iWidth, iHeight = pRenderer->iHeight;
 	pGraph->iMargin = floor (MIN (iWidth, iHeight) / 32);
+	_free_curves_surfaces (pGraph);  // the size has changed, they will be re-created on the next drawing.
+	if (pGraph->pCurvesMinMaxValues == NULL)  // not loaded yet (null size)
+		pGraph->pCurvesMinMaxValues = g_new0 (gdouble, 2 * iNbValues);
 	if (pGraph->pBackgroundSurface != NULL)
 		cairo_surface_destroy (pGraph->pBackgroundSurface);
 	pGraph->pBackgroundSurface = _cairo_dock_create_graph_background (iWidth, iHeight, pGraph->iMargin, pGraph->fBackGroundColor, pGraph->iType, iNbValues / pRenderer->iRank);
@@ -516,6 +655,7 @@ static void unload (Graph *pGraph)
 		cairo_surface_destroy (pGraph->pBackgroundSurface);
 	if (pGraph->iBackgroundTexture != 0)
 		_cairo_dock_delete_texture (pGraph->iBackgroundTexture);
+	_free_curves_surfaces (pGraph);
 	
 	CairoDataRenderer *pRenderer = CAIRO_DATA_RENDERER (pGraph);
 	int iNbValues = cairo_data_renderer_get_nb_values (pRenderer);
@@ -529,6 +669,7 @@ static void unload (Graph *pGraph)
 	g_free (pGraph->pGradationPatterns);
 	g_free (pGraph->fHighColor);
 	g_free (pGraph->fLowColor);
+	g_free (pGraph->pCurvesMinMaxValues);
 }
 
 
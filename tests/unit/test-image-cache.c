@@ -0,0 +1,207 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Unit tests of the image cache: an entry must not be used once the original image has changed, or once the cache has been cleared.
+
+#include <stdlib.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <cairo.h>
+
+#include "cairo-dock-image-cache.h"
+
+#define ICON_SIZE 16
+
+static gchar *s_cTmpDir = NULL;
+
+static gchar *_write_image (const gchar *cName, const gchar *cContent)
+{
+	// the cache doesn't decode the original file, it only identifies it.
+	gchar *cImagePath = g_build_filename (s_cTmpDir, cName, NULL);
+	g_assert (g_file_set_contents (cImagePath, cContent, -1, NULL));
+	return cImagePath;
+}
+
+static cairo_surface_t *_make_surface (double r, double g, double b)
+{
+	cairo_surface_t *pSurface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, ICON_SIZE, ICON_SIZE);
+	cairo_t *pCairoContext = cairo_create (pSurface);
+	cairo_set_source_rgb (pCairoContext, r, g, b);
+	cairo_paint (pCairoContext);
+	cairo_destroy (pCairoContext);
+	return pSurface;
+}
+
+static void _store (const gchar *cImagePath, cairo_surface_t *pSurface)
+{
+	gldi_image_cache_store (cImagePath, ICON_SIZE, ICON_SIZE, 0, pSurface, ICON_SIZE, ICON_SIZE, 1., 1.);
+}
+
+static cairo_surface_t *_lookup (const gchar *cImagePath, int iSize)
+{
+	double fImageWidth = 0, fImageHeight = 0;
+	cairo_surface_t *pSurface = gldi_image_cache_lookup (cImagePath, iSize, iSize, 0, &fImageWidth, &fImageHeight, NULL, NULL);
+	if (pSurface != NULL)
+	{
+		g_assert_cmpfloat (fImageWidth, ==, ICON_SIZE);
+		g_assert_cmpfloat (fImageHeight, ==, ICON_SIZE);
+	}
+	return pSurface;
+}
+
+static guint32 _get_pixel (cairo_surface_t *pSurface)
+{
+	cairo_surface_flush (pSurface);
+	return *(guint32*)cairo_image_surface_get_data (pSurface);
+}
+
+
+static void test_hit (void)
+{
+	gchar *cImagePath = _write_image ("hit.svg", "<svg/>");
+	cairo_surface_t *pSurface = _make_surface (1., 0., 0.);
+	_store (cImagePath, pSurface);
+
+	cairo_surface_t *pCachedSurface = _lookup (cImagePath, ICON_SIZE);
+	g_assert (pCachedSurface != NULL);
+	g_assert_cmpuint (_get_pixel (pCachedSurface), ==, _get_pixel (pSurface));
+	g_assert (_lookup (cImagePath, 2 * ICON_SIZE) == NULL);  // another size is another entry.
+
+	cairo_surface_destroy (pCachedSurface);
+	cairo_surface_destroy (pSurface);
+	g_free (cImagePath);
+}
+
+static void test_invalidated_by_modification (void)
+{
+	gchar *cImagePath = _write_image ("modified.svg", "<svg/>");
+	cairo_surface_t *pSurface = _make_surface (0., 1., 0.);
+	_store (cImagePath, pSurface);
+	cairo_surface_t *pCachedSurface = _lookup (cImagePath, ICON_SIZE);
+	g_assert (pCachedSurface != NULL);
+	cairo_surface_destroy (pCachedSurface);
+
+	// modify the image (the size changes, so it's detected even within the same second).
+	g_free (_write_image ("modified.svg", "<svg width='2'/>"));
+	g_assert (_lookup (cImagePath, ICON_SIZE) == NULL);
+
+	// the new version can be stored and found again.
+	cairo_surface_t *pNewSurface = _make_surface (0., 0., 1.);
+	_store (cImagePath, pNewSurface);
+	pCachedSurface = _lookup (cImagePath, ICON_SIZE);
+	g_assert (pCachedSurface != NULL);
+	g_assert_cmpuint (_get_pixel (pCachedSurface), ==, _get_pixel (pNewSurface));
+
+	cairo_surface_destroy (pCachedSurface);
+	cairo_surface_destroy (pNewSurface);
+	cairo_surface_destroy (pSurface);
+	g_free (cImagePath);
+}
+
+static void test_invalidated_by_replacement (void)
+{
+	gchar *cImagePath = _write_image ("replaced.svg", "<svg/>");
+	cairo_surface_t *pSurface = _make_surface (1., 1., 0.);
+	_store (cImagePath, pSurface);
+
+	// replace the image by another file with the same content (e.g. a theme that is re-installed).
+	gchar *cOtherPath = _write_image ("other.svg", "<svg/>");
+	g_assert_cmpint (g_rename (cOtherPath, cImagePath), ==, 0);
+	g_assert (_lookup (cImagePath, ICON_SIZE) == NULL);
+
+	cairo_surface_destroy (pSurface);
+	g_free (cOtherPath);
+	g_free (cImagePath);
+}
+
+static void test_invalidated_by_clear (void)
+{
+	gchar *cImagePath = _write_image ("cleared.svg", "<svg/>");
+	cairo_surface_t *pSurface = _make_surface (1., 0., 1.);
+	_store (cImagePath, pSurface);
+	cairo_surface_t *pCachedSurface = _lookup (cImagePath, ICON_SIZE);
+	g_assert (pCachedSurface != NULL);
+	cairo_surface_destroy (pCachedSurface);
+
+	gldi_image_cache_clear ();
+	g_assert (_lookup (cImagePath, ICON_SIZE) == NULL);
+
+	_store (cImagePath, pSurface);  // the cache is still usable after that.
+	pCachedSurface = _lookup (cImagePath, ICON_SIZE);
+	g_assert (pCachedSurface != NULL);
+
+	cairo_surface_destroy (pCachedSurface);
+	cairo_surface_destroy (pSurface);
+	g_free (cImagePath);
+}
+
+static void test_corrupted_entry (void)
+{
+	gchar *cImagePath = _write_image ("corrupted.svg", "<svg/>");
+	cairo_surface_t *pSurface = _make_surface (0., 1., 1.);
+	_store (cImagePath, pSurface);
+
+	// truncate all the entries, as if the dock had been killed while writing them.
+	gchar *cCacheDir = g_build_filename (g_get_user_cache_dir (), "cairo-dock", "images", NULL);
+	GDir *dir = g_dir_open (cCacheDir, 0, NULL);
+	g_assert (dir != NULL);
+	const gchar *cFileName;
+	while ((cFileName = g_dir_read_name (dir)) != NULL)
+	{
+		gchar *cEntryPath = g_build_filename (cCacheDir, cFileName, NULL);
+		g_assert (g_file_set_contents (cEntryPath, "CDIC", -1, NULL));
+		g_free (cEntryPath);
+	}
+	g_dir_close (dir);
+
+	g_assert (_lookup (cImagePath, ICON_SIZE) == NULL);
+
+	g_free (cCacheDir);
+	cairo_surface_destroy (pSurface);
+	g_free (cImagePath);
+}
+
+
+int main (int argc, char **argv)
+{
+	g_test_init (&argc, &argv, NULL);
+
+	// work in a temporary folder, including the cache itself (it must be set before GLib reads it).
+	s_cTmpDir = g_dir_make_tmp ("cairo-dock-test-XXXXXX", NULL);
+	g_assert (s_cTmpDir != NULL);
+	gchar *cCacheDir = g_build_filename (s_cTmpDir, "cache", NULL);
+	g_setenv ("XDG_CACHE_HOME", cCacheDir, TRUE);
+	g_free (cCacheDir);
+
+	g_test_add_func ("/image-cache/hit", test_hit);
+	g_test_add_func ("/image-cache/invalidated-by-modification", test_invalidated_by_modification);
+	g_test_add_func ("/image-cache/invalidated-by-replacement", test_invalidated_by_replacement);
+	g_test_add_func ("/image-cache/invalidated-by-clear", test_invalidated_by_clear);
+	g_test_add_func ("/image-cache/corrupted-entry", test_corrupted_entry);
+
+	int r = g_test_run ();
+
+	gldi_image_cache_clear ();
+	gchar *cCommand = g_strdup_printf ("rm -rf '%s'", s_cTmpDir);
+	if (system (cCommand) != 0)
+		g_printerr ("couldn't remove %s\n", s_cTmpDir);
+	g_free (cCommand);
+	g_free (s_cTmpDir);
+	return r;
+}
@@ -0,0 +1,173 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Unit tests of the scheduler of the periodic tasks.
+// The tests check the dates the tasks are scheduled on, which don't depend on the load of the machine, rather than the time elapsed between 2 updates.
+
+#include <string.h>
+#include <glib.h>
+
+#include "cairo-dock-task.h"
+
+#define NB_MAX_LAUNCHES 8
+#define SAFETY_TIMEOUT 20000  // ms; only reached if the task is never updated.
+
+typedef struct {
+	GldiTask *pTask;
+	gint iNbUpdates;
+	gint64 pLaunchDates[NB_MAX_LAUNCHES];  // date of each update.
+	gint64 pEndDates[NB_MAX_LAUNCHES];  // date each update returned.
+	gint64 pNextIterations[NB_MAX_LAUNCHES];  // date of the next iteration, as scheduled during each update (0 for the first launch, which is not scheduled).
+	gint iBlockingLaunch;  // the update of this launch blocks the main loop for a while, as if the computer had been suspended.
+	gulong iBlockingDelay;  // in us
+	} TestData;
+
+static void _init_data (TestData *pData)
+{
+	memset (pData, 0, sizeof (TestData));
+	pData->iBlockingLaunch = -1;
+}
+
+static gboolean _update (TestData *pData)
+{
+	gint i = pData->iNbUpdates;
+	if (i < NB_MAX_LAUNCHES)
+	{
+		pData->pLaunchDates[i] = g_get_monotonic_time ();
+		pData->pNextIterations[i] = pData->pTask->iNextIteration;
+	}
+	if (i == pData->iBlockingLaunch)
+		g_usleep (pData->iBlockingDelay);
+	if (i < NB_MAX_LAUNCHES)
+		pData->pEndDates[i] = g_get_monotonic_time ();
+	pData->iNbUpdates ++;
+	return TRUE;
+}
+
+static GldiTask *_new_task (TestData *pData, int iPeriod)
+{
+	pData->pTask = gldi_task_new_full (iPeriod, NULL, (GldiUpdateSyncFunc) _update, NULL, pData);
+	return pData->pTask;
+}
+
+static gboolean _on_timeout (gboolean *bTimeout)
+{
+	*bTimeout = TRUE;
+	return FALSE;
+}
+
+// run the main loop until the task has been updated a given number of times, or for a given duration if it's not updated.
+static void _run_main_loop (TestData *pData, gint iNbUpdates, guint iMaxDuration)
+{
+	gboolean bTimeout = FALSE;
+	guint iSidTimeout = g_timeout_add (iMaxDuration, (GSourceFunc) _on_timeout, &bTimeout);
+	while (! bTimeout && (iNbUpdates < 0 || pData->iNbUpdates < iNbUpdates))
+		g_main_context_iteration (NULL, TRUE);
+	if (! bTimeout)
+		g_source_remove (iSidTimeout);
+}
+
+// a periodic iteration is never launched before the date it was scheduled on.
+static void _check_launch_dates (TestData *pData)
+{
+	int i;
+	for (i = 1; i < MIN (pData->iNbUpdates, NB_MAX_LAUNCHES); i ++)
+		g_assert_cmpint (pData->pLaunchDates[i], >=, pData->pNextIterations[i-1]);
+}
+
+
+  /////////////////
+ /// SCHEDULER ///
+/////////////////
+
+static void test_reschedule_from_deadline (void)
+{
+	TestData data;
+	_init_data (&data);
+	data.iBlockingLaunch = 1;  // the update takes some time: the next iteration must not be delayed by it.
+	data.iBlockingDelay = 300000;
+	GldiTask *pTask = _new_task (&data, 2);  // long enough for the timer to not be late by a whole period on a loaded machine.
+
+	gldi_task_launch (pTask);
+	g_assert (gldi_task_is_active (pTask));
+	_run_main_loop (&data, 3, SAFETY_TIMEOUT);
+	g_assert_cmpint (data.iNbUpdates, ==, 3);
+	_check_launch_dates (&data);
+
+	// the next iteration is a period after the previous deadline, not after the end of the update.
+	g_assert_cmpint (data.pNextIterations[2] - data.pNextIterations[1], ==, 2 * G_USEC_PER_SEC);
+
+	gldi_task_free (pTask);
+}
+
+static void test_reschedule_when_late (void)
+{
+	TestData data;
+	_init_data (&data);
+	data.iBlockingLaunch = 1;  // the main loop is blocked for more than 2 periods.
+	data.iBlockingDelay = 2500000;
+	GldiTask *pTask = _new_task (&data, 1);
+
+	gldi_task_launch (pTask);
+	_run_main_loop (&data, 4, SAFETY_TIMEOUT);
+	g_assert_cmpint (data.iNbUpdates, ==, 4);
+	_check_launch_dates (&data);
+
+	// the missed iterations are not launched in a row: the late one is launched once, and the next one is scheduled a period after it rather than on the missed deadlines.
+	g_assert_cmpint (data.pNextIterations[2], >=, data.pEndDates[1] + G_USEC_PER_SEC);
+
+	gldi_task_free (pTask);
+}
+
+static void test_stop_periodic_task (void)
+{
+	TestData data;
+	_init_data (&data);
+	GldiTask *pTask = _new_task (&data, 1);
+
+	gldi_task_launch (pTask);
+	g_assert_cmpint (data.iNbUpdates, ==, 1);
+	g_assert (gldi_task_is_active (pTask));
+
+	gldi_task_stop (pTask);
+	g_assert (! gldi_task_is_active (pTask));
+	g_assert_cmpint (pTask->iNextIteration, ==, 0);  // the scheduled iteration has been cancelled.
+	_run_main_loop (&data, -1, 1500);
+	g_assert_cmpint (data.iNbUpdates, ==, 1);
+
+	gldi_task_launch (pTask);  // and the task can be relaunched.
+	_run_main_loop (&data, 3, SAFETY_TIMEOUT);
+	g_assert_cmpint (data.iNbUpdates, ==, 3);
+
+	gldi_task_free (pTask);
+}
+
+
+int main (int argc, char **argv)
+{
+	g_test_init (&argc, &argv, NULL);
+
+	myTasksParam.iTimerSlack = 0;
+
+	g_test_add_func ("/task/scheduler/reschedule-from-deadline", test_reschedule_from_deadline);
+	g_test_add_func ("/task/scheduler/reschedule-when-late", test_reschedule_when_late);
+	g_test_add_func ("/task/scheduler/stop-periodic-task", test_stop_periodic_task);
+
+	return g_test_run ();
+}
@@ -0,0 +1,241 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Unit tests of the tasks: stopping or discarding a task while it's in the pool.
+// No assertion relies on how long something took: the tests wait for the task to reach a given state, with a generous timeout as a safety net only.
+
+#include <string.h>
+#include <glib.h>
+
+#include "cairo-dock-task.h"
+
+#define SAFETY_TIMEOUT 10000  // ms; only reached if the task never gets to the expected state.
+
+typedef struct {
+	gint iNbGetData;  // accessed from the threads of the pool.
+	gint iNbUpdates;
+	gboolean bFreed;
+	gboolean bBlockGetData;  // the 'get_data' waits until it's released.
+	gint bGetDataStarted;
+	GMutex mutex;
+	GCond cond;
+	gboolean bReleased;
+	gboolean bReleasedByWatchdog;
+	} TestData;
+
+static void _init_data (TestData *pData)
+{
+	memset (pData, 0, sizeof (TestData));
+	g_mutex_init (&pData->mutex);
+	g_cond_init (&pData->cond);
+}
+
+static void _clear_data (TestData *pData)
+{
+	g_mutex_clear (&pData->mutex);
+	g_cond_clear (&pData->cond);
+}
+
+static void _get_data (TestData *pData)
+{
+	g_atomic_int_set (&pData->bGetDataStarted, 1);
+	if (pData->bBlockGetData)
+	{
+		g_mutex_lock (&pData->mutex);
+		while (! pData->bReleased)
+			g_cond_wait (&pData->cond, &pData->mutex);
+		g_mutex_unlock (&pData->mutex);
+	}
+	g_atomic_int_inc (&pData->iNbGetData);
+}
+
+static gboolean _update (TestData *pData)
+{
+	pData->iNbUpdates ++;
+	return TRUE;
+}
+
+static void _free_data (TestData *pData)
+{
+	pData->bFreed = TRUE;
+}
+
+static void _release_get_data (TestData *pData)
+{
+	g_mutex_lock (&pData->mutex);
+	pData->bReleased = TRUE;
+	g_cond_broadcast (&pData->cond);  // the 'get_data' and the watchdog may both be waiting.
+	g_mutex_unlock (&pData->mutex);
+}
+
+// releases the 'get_data' if nobody did it in time, so that a test that would block forever fails instead.
+static gpointer _watchdog (TestData *pData)
+{
+	gint64 iEndTime = g_get_monotonic_time () + SAFETY_TIMEOUT * G_TIME_SPAN_MILLISECOND;
+	g_mutex_lock (&pData->mutex);
+	while (! pData->bReleased)
+	{
+		if (! g_cond_wait_until (&pData->cond, &pData->mutex, iEndTime))
+		{
+			pData->bReleasedByWatchdog = TRUE;
+			pData->bReleased = TRUE;
+			g_cond_broadcast (&pData->cond);
+		}
+	}
+	g_mutex_unlock (&pData->mutex);
+	return NULL;
+}
+
+static gpointer _release_get_data_later (TestData *pData)
+{
+	g_usleep (G_USEC_PER_SEC / 2);  // only to give 'gldi_task_stop' a chance to wait for it; the test passes whatever the order.
+	_release_get_data (pData);
+	return NULL;
+}
+
+static void _wait_for_get_data (TestData *pData)
+{
+	gint64 iEndTime = g_get_monotonic_time () + SAFETY_TIMEOUT * G_TIME_SPAN_MILLISECOND;
+	while (! g_atomic_int_get (&pData->bGetDataStarted) && g_get_monotonic_time () < iEndTime)
+		g_usleep (10000);
+	g_assert (g_atomic_int_get (&pData->bGetDataStarted));
+}
+
+static gboolean _on_timeout (gboolean *bTimeout)
+{
+	*bTimeout = TRUE;
+	return FALSE;
+}
+
+// run the main loop until a condition is fulfilled.
+#define _run_main_loop_until(bCondition) do {\
+	gboolean _bTimeout = FALSE;\
+	guint _iSidTimeout = g_timeout_add (SAFETY_TIMEOUT, (GSourceFunc) _on_timeout, &_bTimeout);\
+	while (! _bTimeout && ! (bCondition))\
+		g_main_context_iteration (NULL, TRUE);\
+	if (! _bTimeout)\
+		g_source_remove (_iSidTimeout);\
+	g_assert (bCondition); } while (0)
+
+static GldiTask *_launch_busy_task (TestData *pBusy)
+{
+	// occupy the only thread of the pool.
+	_init_data (pBusy);
+	pBusy->bBlockGetData = TRUE;
+	GldiTask *pBusyTask = gldi_task_new_full (0, (GldiGetDataAsyncFunc) _get_data, (GldiUpdateSyncFunc) _update, NULL, pBusy);
+	gldi_task_launch (pBusyTask);
+	_wait_for_get_data (pBusy);
+	return pBusyTask;
+}
+
+
+  //////////////
+ /// CANCEL ///
+//////////////
+
+static void test_stop_queued_task (void)
+{
+	TestData busy;
+	GldiTask *pBusyTask = _launch_busy_task (&busy);
+
+	// launch a task, that waits in the pool.
+	TestData data;
+	_init_data (&data);
+	GldiTask *pTask = gldi_task_new_full (0, (GldiGetDataAsyncFunc) _get_data, (GldiUpdateSyncFunc) _update, NULL, &data);
+	gldi_task_launch (pTask);
+	g_assert (gldi_task_is_running (pTask));
+
+	// stopping it must not wait for a thread to be available: the busy task is only released once we're back, or by the watchdog if we were stuck.
+	GThread *pThread = g_thread_new ("watchdog", (GThreadFunc) _watchdog, &busy);
+	gldi_task_stop (pTask);
+	g_assert (! gldi_task_is_running (pTask));
+	_release_get_data (&busy);
+	g_thread_join (pThread);
+	g_assert (! busy.bReleasedByWatchdog);
+
+	// the outdated launch goes through the pool, but neither gets the data nor updates the task.
+	_run_main_loop_until (busy.iNbUpdates == 1 && pTask->iNbLaunches == 0);
+	g_assert_cmpint (g_atomic_int_get (&data.iNbGetData), ==, 0);
+	g_assert_cmpint (data.iNbUpdates, ==, 0);
+
+	gldi_task_free (pTask);
+	gldi_task_free (pBusyTask);
+	_clear_data (&data);
+	_clear_data (&busy);
+}
+
+static void test_stop_running_task (void)
+{
+	TestData data;
+	_init_data (&data);
+	data.bBlockGetData = TRUE;
+	GldiTask *pTask = gldi_task_new_full (0, (GldiGetDataAsyncFunc) _get_data, (GldiUpdateSyncFunc) _update, NULL, &data);
+	gldi_task_launch (pTask);
+	_wait_for_get_data (&data);
+
+	// stopping it waits for the 'get_data' to finish, then the update is dropped.
+	GThread *pThread = g_thread_new ("release", (GThreadFunc) _release_get_data_later, &data);
+	gldi_task_stop (pTask);
+	g_assert (! gldi_task_is_running (pTask));
+	g_assert_cmpint (g_atomic_int_get (&data.iNbGetData), ==, 1);
+	g_thread_join (pThread);
+
+	_run_main_loop_until (pTask->iNbLaunches == 0);
+	g_assert_cmpint (data.iNbUpdates, ==, 0);
+
+	gldi_task_free (pTask);
+	_clear_data (&data);
+}
+
+static void test_discard_queued_task (void)
+{
+	TestData busy;
+	GldiTask *pBusyTask = _launch_busy_task (&busy);
+
+	TestData data;
+	_init_data (&data);
+	GldiTask *pTask = gldi_task_new_full (0, (GldiGetDataAsyncFunc) _get_data, (GldiUpdateSyncFunc) _update, (GFreeFunc) _free_data, &data);
+	gldi_task_launch (pTask);
+	gldi_task_discard (pTask);  // the task is freed once its launch has left the pool.
+	g_assert (! data.bFreed);
+
+	_release_get_data (&busy);
+	_run_main_loop_until (data.bFreed);
+	g_assert_cmpint (g_atomic_int_get (&data.iNbGetData), ==, 0);
+	g_assert_cmpint (data.iNbUpdates, ==, 0);
+
+	_run_main_loop_until (busy.iNbUpdates == 1);
+	gldi_task_free (pBusyTask);
+	_clear_data (&data);
+	_clear_data (&busy);
+}
+
+
+int main (int argc, char **argv)
+{
+	g_test_init (&argc, &argv, NULL);
+
+	myTasksParam.iNbThreads = 1;  // so that a task can be kept waiting in the pool.
+
+	g_test_add_func ("/task/cancel/stop-queued-task", test_stop_queued_task);
+	g_test_add_func ("/task/cancel/stop-running-task", test_stop_running_task);
+	g_test_add_func ("/task/cancel/discard-queued-task", test_discard_queued_task);
+
+	return g_test_run ();
+}